@@ -0,0 +1,179 @@
+/**
+ * @file astar_search.h
+ * @brief A* over packed boards, templated on the heuristic
+ *
+ * The heuristic is a template parameter (see heuristics.h for the interface),
+ * so its incremental update is inlined into the expansion loop: Manhattan
+ * distance gives the h1 solver, misplaced tiles h2, PdbHeuristic the
+ * pattern-database variant. Side > 0 fixes the board side at compile time
+ * (see BoardDim); pair it with a heuristic instantiated for the same side.
+ *
+ * The closed table keeps the g each state was expanded with, and a closed
+ * state reached again with a smaller g is reopened. Manhattan distance and
+ * misplaced tiles are consistent, so this never happens with them; the
+ * additive PDB is only admissible (each entry is a minimum over all blank
+ * positions, so h can drop by more than one per move), and closing states
+ * for good would return longer than optimal solutions.
+ */
+#ifndef ASTAR_SEARCH_H
+#define ASTAR_SEARCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "puzzle_board.h"
+#include "heuristics.h"
+#include "state_table.h"
+#include "open_list.h"
+#include "move_tables.h"
+#include "node_arena.h"
+#include "instrumentation.h"
+
+namespace puzzle {
+
+template <typename Word>
+struct AStarNode {
+    PackedBoard<Word> board;
+    int g, h, f;
+    uint32_t parent;   // arena index, NO_PARENT for the start
+    uint8_t move;      // Move that produced this state
+    
+    AStarNode() : g(0), h(0), f(0), parent(NO_PARENT), move(MOVE_NONE) {}
+    
+    bool operator==(const AStarNode& other) const {
+        return board == other.board;
+    }
+};
+
+template <typename Word, typename Heuristic = ManhattanHeuristic<Word>, int Side = 0>
+class AStar_NSize {
+private:
+    BoardDim<Side> N;
+    PackedBoard<Word> goal;
+    int total_nodes_expanded;
+    MoveTable moves;
+    
+    // Memory limit to prevent crashes
+    static const int MAX_STATES = 1000000;
+    StateTable<Word, int> closed;        // g each state was expanded with
+    NodeArena<AStarNode<Word> > nodes;   // reused across puzzles
+    BucketOpenList frontier;             // indices into `nodes`
+    uint32_t solution_node;
+    Heuristic heuristic;
+    
+    void generateGoal() {
+        goal = goalBoard<Word>(N);
+    }
+    
+    // Fills `neighbors` (capacity 4) with the children of nodes[index],
+    // except the one that undoes the move into it
+    int getNeighbors(uint32_t index, AStarNode<Word>* neighbors) {
+        const AStarNode<Word>& current = nodes[index];
+        const BlankMoves& legal = moves.at(current.board.blank);
+        int count = 0;
+        
+        for (int k = 0; k < legal.count; k++) {
+            if (undoes(legal.move[k], current.move)) continue;
+            int from = legal.target[k];
+            AStarNode<Word>& neighbor = neighbors[count++];
+            neighbor = current;
+            int tile = neighbor.board.slide(from);
+            neighbor.g = current.g + 1;
+            neighbor.h = PUZZLE_TIMED(PHASE_HEURISTIC,
+                                      heuristic.update(current.h, neighbor.board, tile, from, current.board.blank));
+            neighbor.f = neighbor.g + neighbor.h;
+            neighbor.parent = index;
+            neighbor.move = static_cast<uint8_t>(legal.move[k]);
+        }
+        return count;
+    }
+    
+    bool isGoal(const AStarNode<Word>& state) {
+        return state.board == goal;
+    }
+    
+public:
+    AStar_NSize(int size, const Heuristic& h) : N(size), total_nodes_expanded(0), moves(size), closed(MAX_STATES), solution_node(NO_PARENT), heuristic(h) {
+        generateGoal();
+    }
+    
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        nodes.reset();
+        frontier.clear();
+        closed.clear();
+        solution_node = NO_PARENT;
+        
+        AStarNode<Word> start;
+        start.board = initial;
+        start.h = PUZZLE_TIMED(PHASE_HEURISTIC, heuristic.initial(start.board));
+        start.f = start.g + start.h;
+        
+        frontier.push(nodes.push(start), start.f, start.h);
+        total_nodes_expanded = 0;
+        
+        AStarNode<Word> neighbors[4];
+        
+        while (!frontier.empty() && closed.size() < static_cast<size_t>(MAX_STATES)) {
+            uint32_t index = PUZZLE_TIMED(PHASE_OPEN_POP, frontier.pop());
+            const AStarNode<Word>& current = nodes[index];
+            
+            bool added = false;
+            int* closed_g = PUZZLE_TIMED(PHASE_HASH_INSERT, closed.insertOrFind(current.board.cells, current.g, added));
+            if (!added) {
+                if (*closed_g <= current.g) {
+                    frontier.markStale();
+                    continue;
+                }
+                *closed_g = current.g;   // a shorter way to a closed state: reopen it
+            }
+            
+            total_nodes_expanded++;
+            
+            if (isGoal(current)) {
+                solution_node = index;
+                auto end_time = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+                execution_time = duration.count() / 1000.0; // Convert to milliseconds
+                return current.g;
+            }
+            
+            int count = PUZZLE_TIMED(PHASE_EXPAND, getNeighbors(index, neighbors));
+            for (int i = 0; i < count; i++) {
+                const int* expanded_g = PUZZLE_TIMED(PHASE_HASH_LOOKUP, closed.find(neighbors[i].board.cells));
+                if (expanded_g != nullptr && *expanded_g <= neighbors[i].g) continue;
+                uint32_t child = PUZZLE_TIMED(PHASE_ALLOC, nodes.push(neighbors[i]));
+                PUZZLE_TIMED(PHASE_OPEN_PUSH, frontier.push(child, neighbors[i].f, neighbors[i].h));
+            }
+        }
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        execution_time = duration.count() / 1000.0;
+        return SOLUTION_LIMIT; // No solution found within limits
+    }
+    
+    int getNodesExpanded() const {
+        return total_nodes_expanded;
+    }
+    
+    // Moves of the blank for the last solved puzzle, empty if none
+    std::string getPath() const {
+        if (solution_node == NO_PARENT) return "";
+        return pathToString(nodes.pathTo(solution_node));
+    }
+    
+    TableStats getTableStats() const {
+        return closed.stats();
+    }
+    
+    OpenListStats getOpenListStats() const {
+        return frontier.stats();
+    }
+};
+
+} // namespace puzzle
+
+#endif // ASTAR_SEARCH_H
@@ -0,0 +1,345 @@
+/**
+ * @file batch_pipeline.h
+ * @brief Streaming batch pipeline: chunked reader -> solver pool -> CSV writer
+ *
+ * For batch files too large to load at once. A reader thread cuts the input
+ * into chunks of a few dozen boards (the callers use 16 to 64, so one hard
+ * board holds back only a few easy ones), a pool of workers solves each chunk
+ * and formats its CSV rows into one string, and a writer thread appends the
+ * chunks to the output with large buffered writes. Memory is bounded by the
+ * number of chunks allowed in flight, not by the size of the input: the
+ * reader waits for a free slot before cutting the next chunk, and the writer
+ * frees the slot once the chunk is on disk.
+ *
+ * The ordered writer keeps chunks that finished early until their turn, so
+ * rows come out in input order; a chunk that takes long stalls the reader
+ * once every slot is waiting behind it. The unordered writer emits chunks as
+ * they complete, which keeps every worker busy at the price of the row order
+ * (rows still carry their puzzle index).
+ *
+ * Stages synchronise once per chunk, so a mutex and a condition variable per
+ * queue cost nothing next to the solving.
+ */
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace puzzle {
+
+/**
+ * @brief One input board and its position in the file (blank lines skipped)
+ */
+struct PuzzleLine {
+    long long index;
+    std::string board;
+};
+
+/**
+ * @brief Reads a puzzles file in large blocks and hands out trimmed lines
+ *
+ * Whitespace inside a line is removed and empty lines are skipped, like the
+ * loaders of the batch solvers.
+ */
+class ChunkedLineReader {
+private:
+    FILE* file_;
+    std::vector<char> block_;
+    size_t pos_, end_;
+    long long next_index_;
+    std::string partial_;
+
+    ChunkedLineReader(const ChunkedLineReader&);
+    ChunkedLineReader& operator=(const ChunkedLineReader&);
+
+    bool refill() {
+        if (file_ == nullptr) return false;
+        end_ = std::fread(block_.data(), 1, block_.size(), file_);
+        pos_ = 0;
+        return end_ > 0;
+    }
+
+public:
+    explicit ChunkedLineReader(const std::string& path, size_t block_bytes = size_t(1) << 20)
+        : file_(std::fopen(path.c_str(), "rb")), block_(block_bytes > 0 ? block_bytes : 1),
+          pos_(0), end_(0), next_index_(0) {}
+
+    ~ChunkedLineReader() {
+        if (file_ != nullptr) std::fclose(file_);
+    }
+
+    bool ok() const { return file_ != nullptr; }
+
+    /**
+     * @brief Appends up to @p max_lines boards to @p out; returns how many (0 at EOF)
+     */
+    size_t next(std::vector<PuzzleLine>& out, size_t max_lines) {
+        size_t added = 0;
+        while (added < max_lines) {
+            if (pos_ == end_ && !refill()) {
+                // Last line without a trailing newline
+                if (!partial_.empty()) {
+                    out.push_back(PuzzleLine{next_index_++, partial_});
+                    partial_.clear();
+                    added++;
+                }
+                break;
+            }
+            char c = block_[pos_++];
+            if (c == '\n') {
+                if (!partial_.empty()) {
+                    out.push_back(PuzzleLine{next_index_++, partial_});
+                    partial_.clear();
+                    added++;
+                }
+            } else if (c != ' ' && c != '\t' && c != '\r' && c != '\v' && c != '\f') {
+                partial_.push_back(c);
+            }
+        }
+        return added;
+    }
+};
+
+/**
+ * @brief Output file written through a large user-space buffer
+ */
+class BufferedWriter {
+private:
+    FILE* file_;
+    bool owns_file_;
+    std::string buffer_;
+    size_t flush_bytes_;
+    size_t written_;
+    bool failed_;
+
+    BufferedWriter(const BufferedWriter&);
+    BufferedWriter& operator=(const BufferedWriter&);
+
+public:
+    explicit BufferedWriter(const std::string& path, size_t buffer_bytes = size_t(4) << 20)
+        : file_(std::fopen(path.c_str(), "wb")), owns_file_(true), flush_bytes_(buffer_bytes), written_(0),
+          failed_(file_ == nullptr) {
+        buffer_.reserve(buffer_bytes);
+    }
+
+    /**
+     * @brief Writes to an already open stream (e.g. stdout), which close() leaves open
+     */
+    explicit BufferedWriter(FILE* file, size_t buffer_bytes = size_t(4) << 20)
+        : file_(file), owns_file_(false), flush_bytes_(buffer_bytes), written_(0), failed_(file == nullptr) {
+        buffer_.reserve(buffer_bytes);
+    }
+
+    ~BufferedWriter() { close(); }
+
+    bool ok() const { return file_ != nullptr; }
+    size_t bytesWritten() const { return written_ + buffer_.size(); }
+
+    void write(const std::string& text) {
+        buffer_ += text;
+        if (buffer_.size() >= flush_bytes_) flush();
+    }
+
+    void flush() {
+        if (file_ != nullptr && !buffer_.empty() &&
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            failed_ = true;
+        }
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    // False if any write failed (e.g. the disk is full) or the file never opened
+    bool close() {
+        if (file_ == nullptr) return !failed_;
+        flush();
+        bool closed = owns_file_ ? std::fclose(file_) == 0 : std::fflush(file_) == 0;
+        failed_ = failed_ || !closed;
+        file_ = nullptr;
+        return !failed_;
+    }
+};
+
+struct PipelineStats {
+    long long boards;
+    size_t chunks;
+    size_t peak_buffered;              // most finished chunks waiting for their turn
+    double wall_ms;
+    std::vector<long long> boards_per_worker;
+};
+
+/**
+ * @brief Runs the reader, @p workers solver threads and the writer to completion
+ *
+ * solve(const PuzzleLine&, int worker, std::string& rows) appends the CSV
+ * row(s) of one board. Per-worker state (tables, arenas) should be indexed by
+ * `worker` so nothing is shared between solver threads.
+ */
+class StreamPipeline {
+private:
+    struct Chunk {
+        size_t seq;
+        std::vector<PuzzleLine> lines;
+        std::string rows;
+    };
+    typedef std::unique_ptr<Chunk> ChunkPtr;
+
+    // Unbounded FIFO; the in-flight limit bounds what can ever be in it
+    class ChunkQueue {
+    private:
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<ChunkPtr> items_;
+        bool closed_;
+
+    public:
+        ChunkQueue() : closed_(false) {}
+
+        void push(ChunkPtr chunk) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                items_.push_back(std::move(chunk));
+            }
+            ready_.notify_one();
+        }
+
+        // nullptr once the queue is closed and drained
+        ChunkPtr pop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return closed_ || !items_.empty(); });
+            if (items_.empty()) return ChunkPtr();
+            ChunkPtr chunk = std::move(items_.front());
+            items_.pop_front();
+            return chunk;
+        }
+
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closed_ = true;
+            }
+            ready_.notify_all();
+        }
+    };
+
+    int workers_;
+    size_t chunk_lines_;
+    size_t max_in_flight_;
+    bool ordered_;
+
+    std::mutex slots_mutex_;
+    std::condition_variable slot_freed_;
+    size_t in_flight_;
+
+    void acquireSlot() {
+        std::unique_lock<std::mutex> lock(slots_mutex_);
+        slot_freed_.wait(lock, [this] { return in_flight_ < max_in_flight_; });
+        in_flight_++;
+    }
+
+    void releaseSlot() {
+        {
+            std::lock_guard<std::mutex> lock(slots_mutex_);
+            in_flight_--;
+        }
+        slot_freed_.notify_one();
+    }
+
+public:
+    /**
+     * @param chunk_lines   boards per chunk
+     * @param max_in_flight chunks read but not yet written (0 = 4 per worker)
+     * @param ordered       write rows in input order
+     */
+    StreamPipeline(int workers, size_t chunk_lines, size_t max_in_flight, bool ordered)
+        : workers_(workers > 0 ? workers : 1), chunk_lines_(chunk_lines > 0 ? chunk_lines : 1),
+          max_in_flight_(max_in_flight > 0 ? max_in_flight : 4 * (size_t)workers_),
+          ordered_(ordered), in_flight_(0) {}
+
+    template <typename Solve>
+    PipelineStats run(ChunkedLineReader& reader, BufferedWriter& out, Solve solve) {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        PipelineStats stats = PipelineStats();
+        stats.boards_per_worker.assign(workers_, 0);
+        ChunkQueue todo, done;
+
+        std::thread reader_thread([&] {
+            for (size_t seq = 0;; seq++) {
+                acquireSlot();
+                ChunkPtr chunk(new Chunk());
+                chunk->seq = seq;
+                chunk->lines.reserve(chunk_lines_);
+                if (reader.next(chunk->lines, chunk_lines_) == 0) {
+                    releaseSlot();
+                    break;
+                }
+                todo.push(std::move(chunk));
+            }
+            todo.close();
+        });
+
+        std::vector<std::thread> solvers;
+        for (int w = 0; w < workers_; w++) {
+            solvers.emplace_back([&, w] {
+                long long boards = 0;
+                for (ChunkPtr chunk = todo.pop(); chunk; chunk = todo.pop()) {
+                    for (size_t i = 0; i < chunk->lines.size(); i++) solve(chunk->lines[i], w, chunk->rows);
+                    boards += (long long)chunk->lines.size();
+                    chunk->lines.clear();
+                    chunk->lines.shrink_to_fit();
+                    done.push(std::move(chunk));
+                }
+                stats.boards_per_worker[w] = boards;
+            });
+        }
+
+        std::thread writer_thread([&] {
+            std::map<size_t, ChunkPtr> waiting;   // ordered mode: finished ahead of their turn
+            size_t next_seq = 0;
+            for (ChunkPtr chunk = done.pop(); chunk; chunk = done.pop()) {
+                stats.chunks++;
+                if (!ordered_) {
+                    out.write(chunk->rows);
+                    releaseSlot();
+                    continue;
+                }
+                size_t seq = chunk->seq;
+                waiting[seq] = std::move(chunk);
+                stats.peak_buffered = std::max(stats.peak_buffered, waiting.size());
+                for (auto it = waiting.find(next_seq); it != waiting.end(); it = waiting.find(next_seq)) {
+                    out.write(it->second->rows);
+                    waiting.erase(it);
+                    next_seq++;
+                    releaseSlot();
+                }
+            }
+            out.flush();
+        });
+
+        reader_thread.join();
+        for (size_t w = 0; w < solvers.size(); w++) solvers[w].join();
+        done.close();
+        writer_thread.join();
+
+        for (int w = 0; w < workers_; w++) stats.boards += stats.boards_per_worker[w];
+        stats.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return stats;
+    }
+};
+
+} // namespace puzzle
+
+#endif // BATCH_PIPELINE_H
@@ -0,0 +1,200 @@
+/**
+ * @file batch_runner.h
+ * @brief The per-puzzle loop shared by the solver executables
+ *
+ * solveBatch reads every board of a batch (text or SPZ1), runs one solver on
+ * it and prints a CSV row or writes an SPR1 record. A solver provides
+ *
+ *   int solve(const PackedBoard<Word>& board, double& execution_time_ms);
+ *       Optimal number of moves, or SOLUTION_LIMIT past the limits.
+ *   getNodesExpanded() const, std::string getPath() const
+ *
+ * Boards go through the parity test first (solveBoard): unsolvable ones are
+ * reported as SOLUTION_UNSOLVABLE right away and never reach the solver. With
+ * a SolutionCache, boards solved before (earlier in the batch, or by another
+ * run sharing the cache file) are answered from it with 0 nodes expanded.
+ *
+ * Executables report extra statistics after each searched puzzle through the
+ * `after(puzzle_index, solver)` hook.
+ */
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "puzzle_board.h"
+#include "puzzle_io.h"
+#include "state_table.h"
+#include "open_list.h"
+#include "solution_cache.h"
+
+namespace puzzle {
+
+struct NoPuzzleHook {
+    template <typename Solver>
+    void operator()(int, const Solver&) const {}
+};
+
+/**
+ * @brief --table-stats: probe statistics of the solver's visited table
+ */
+struct TableStatsHook {
+    bool enabled;
+
+    explicit TableStatsHook(bool on) : enabled(on) {}
+
+    template <typename Solver>
+    void operator()(int puzzle_index, const Solver& solver) const {
+        if (!enabled) return;
+        TableStats ts = solver.getTableStats();
+        std::cerr << "table puzzle=" << puzzle_index
+                  << " size=" << ts.size
+                  << " capacity=" << ts.capacity
+                  << " load=" << ts.loadFactor()
+                  << " avg_probe=" << ts.averageProbe()
+                  << " max_probe=" << ts.max_probe << std::endl;
+    }
+};
+
+/**
+ * @brief --table-stats and --open-stats of the A* solvers
+ */
+struct SearchStatsHook {
+    TableStatsHook table;
+    bool open_stats;
+
+    SearchStatsHook(bool table_stats, bool open) : table(table_stats), open_stats(open) {}
+
+    template <typename Solver>
+    void operator()(int puzzle_index, const Solver& solver) const {
+        table(puzzle_index, solver);
+        if (!open_stats) return;
+        OpenListStats os = solver.getOpenListStats();
+        std::cerr << "open puzzle=" << puzzle_index
+                  << " pushes=" << os.pushes
+                  << " pops=" << os.pops
+                  << " stale=" << os.stale
+                  << " stale_ratio=" << os.staleRatio()
+                  << " peak=" << os.peak << std::endl;
+    }
+};
+
+/**
+ * @brief Outcome of one board: what a CSV row or an SPR1 record reports
+ */
+struct BoardResult {
+    int solution_length;
+    double execution_time;
+    long long nodes_expanded;
+    std::string path;
+    bool searched;   // false when parity or the cache answered
+
+    BoardResult() : solution_length(SOLUTION_LIMIT), execution_time(0.0), nodes_expanded(0), searched(false) {}
+};
+
+/**
+ * @brief Solves one valid board, behind the parity pre-filter and the optional @p cache
+ *
+ * A cache hit reports the lookup time. Solved boards are stored in the cache
+ * with their path, so later hits can answer --paths too.
+ */
+template <typename Word, typename Solver>
+void solveBoard(Solver& solver, const PackedBoard<Word>& board, int N, bool paths,
+                SolutionCache* cache, BoardResult& r) {
+    if (!isSolvable(board, N)) {
+        r.solution_length = SOLUTION_UNSOLVABLE;
+        return;
+    }
+    if (cache != nullptr) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        if (cache->lookup(board, r.solution_length, paths ? &r.path : nullptr)) {
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start_time);
+            r.execution_time = duration.count() / 1000.0;
+            return;
+        }
+    }
+    r.solution_length = solver.solve(board, r.execution_time);
+    r.nodes_expanded = solver.getNodesExpanded();
+    r.searched = true;
+    if (paths || cache != nullptr) r.path = solver.getPath();
+    if (cache != nullptr && r.solution_length >= 0) cache->store(board, r.solution_length, r.path);
+}
+
+inline void writeCsvHeader(std::ostream& out, bool paths) {
+    out << "puzzle_index,board,solution_length,execution_time_ms,nodes_expanded,solvable,algorithm"
+        << (paths ? ",path" : "") << '\n';
+}
+
+/**
+ * @brief One CSV row in the *_nsize format; @p path is nullptr without --paths
+ */
+inline void writeCsvRow(std::ostream& out, long long puzzle_index, const std::string& board,
+                        int solution_length, double execution_time, long long nodes_expanded,
+                        const char* algorithm, const std::string* path) {
+    out << puzzle_index << ","
+        << board << ","
+        << solution_length << ","
+        << execution_time << ","
+        << nodes_expanded << ","
+        << (solution_length >= 0 ? "true" : "false") << ","
+        << algorithm;
+    if (path != nullptr) out << "," << *path;
+    out << '\n';
+}
+
+/**
+ * @brief Solves every board of @p file with @p solver; false on an I/O error
+ */
+template <typename Word, typename Solver, typename Hook>
+bool solveBatch(std::istream& file, int N, Solver& solver, const char* algorithm, bool paths,
+                const BatchFormat& format, const Hook& after, SolutionCache* cache = nullptr) {
+    BoardReader<Word> input(file, N, format.binary_input);
+    ResultFileWriter results;
+    bool csv = format.results_file.empty();
+    std::string error;
+    if (!input.ok() || (!csv && !results.open(format.results_file, N, algorithm, error))) {
+        std::cerr << "Error: " << (input.ok() ? error : input.error()) << std::endl;
+        return false;
+    }
+    int puzzle_count = 0;
+
+    if (csv) writeCsvHeader(std::cout, paths);
+
+    PackedBoard<Word> board;
+    bool valid = false;
+    while (input.next(board, valid)) {
+        BoardResult r;
+        if (valid) {
+            solveBoard(solver, board, N, paths, cache, r);
+        } else {
+            std::cerr << "Error: Invalid " << N << "x" << N << " board '" << input.text(board, valid) << "'" << std::endl;
+        }
+
+        if (csv) {
+            writeCsvRow(std::cout, puzzle_count, input.text(board, valid), r.solution_length, r.execution_time,
+                        r.nodes_expanded, algorithm, paths ? &r.path : nullptr);
+        } else {
+            results.write(puzzle_count, r.solution_length, r.execution_time, r.nodes_expanded);
+        }
+
+        if (r.searched) after(puzzle_count, solver);
+        puzzle_count++;
+    }
+
+    if (!input.ok()) {
+        std::cerr << "Error: " << input.error() << std::endl;
+        return false;
+    }
+    if (!results.close()) {
+        std::cerr << "Error: cannot write " << format.results_file << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace puzzle
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,334 @@
+/**
+ * @file bfs_search.h
+ * @brief Breadth-first solvers: plain BFS, bidirectional BFS, level-parallel BFS
+ *
+ * All three share the solver interface used by batch_runner.h:
+ * solve(board, time_ms) returns the optimal number of moves or -1 past the
+ * state limit, plus getNodesExpanded(), getPath() and getTableStats().
+ * BFS_NSize and BiBFS_NSize take the board side as an optional compile-time
+ * Side (see BoardDim). For Side = 3, BFS_NSize marks visited boards in a
+ * RankedStateSet (one bit per 3x3 board) instead of a hash table.
+ */
+#ifndef BFS_SEARCH_H
+#define BFS_SEARCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "puzzle_board.h"
+#include "state_table.h"
+#include "level_bfs.h"
+#include "move_tables.h"
+#include "node_arena.h"
+#include "instrumentation.h"
+
+namespace puzzle {
+
+template <typename Word>
+struct BfsNode {
+    PackedBoard<Word> board;
+    int g;
+    uint32_t parent;   // arena index, NO_PARENT for the start
+    uint8_t move;      // Move that produced this state
+    
+    BfsNode() : g(0), parent(NO_PARENT), move(MOVE_NONE) {}
+    
+    bool operator==(const BfsNode& other) const {
+        return board == other.board;
+    }
+};
+
+template <typename Word, int Side = 0>
+class BFS_NSize {
+private:
+    BoardDim<Side> N;
+    PackedBoard<Word> goal;
+    int total_nodes_expanded;
+    MoveTable moves;
+    
+    // Memory limit to prevent crashes
+    static const int MAX_STATES = 1000000;
+    typedef typename std::conditional<Side == 3, RankedStateSet<Word>, StateTable<Word> >::type VisitedSet;
+    VisitedSet visited;
+    // Every generated state in BFS order: the arena is also the FIFO queue
+    NodeArena<BfsNode<Word> > nodes;
+    uint32_t solution_node;
+    
+    void generateGoal() {
+        goal = goalBoard<Word>(N);
+    }
+    
+    // Fills `neighbors` (capacity 4) with the children of nodes[index],
+    // except the one that undoes the move into it
+    int getNeighbors(uint32_t index, BfsNode<Word>* neighbors) {
+        const BfsNode<Word>& current = nodes[index];
+        const BlankMoves& legal = moves.at(current.board.blank);
+        int count = 0;
+        
+        for (int k = 0; k < legal.count; k++) {
+            if (undoes(legal.move[k], current.move)) continue;
+            BfsNode<Word>& neighbor = neighbors[count++];
+            neighbor = current;
+            neighbor.board.slide(legal.target[k]);
+            neighbor.g = current.g + 1;
+            neighbor.parent = index;
+            neighbor.move = static_cast<uint8_t>(legal.move[k]);
+        }
+        return count;
+    }
+    
+    bool isGoal(const BfsNode<Word>& state) {
+        return state.board == goal;
+    }
+    
+public:
+    BFS_NSize(int size) : N(size), total_nodes_expanded(0), moves(size), visited(MAX_STATES), solution_node(NO_PARENT) {
+        generateGoal();
+    }
+    
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        nodes.reset();
+        visited.clear();
+        solution_node = NO_PARENT;
+        
+        BfsNode<Word> root;
+        root.board = initial;
+        nodes.push(root);
+        visited.insert(initial.cells);
+        total_nodes_expanded = 0;
+        
+        BfsNode<Word> neighbors[4];
+        uint32_t head = 0;
+        
+        while (head < nodes.size() && visited.size() < static_cast<size_t>(MAX_STATES)) {
+            uint32_t index = head++;
+            total_nodes_expanded++;
+            
+            if (isGoal(nodes[index])) {
+                solution_node = index;
+                auto end_time = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+                execution_time = duration.count() / 1000.0; // Convert to milliseconds
+                return nodes[index].g;
+            }
+            
+            int count = PUZZLE_TIMED(PHASE_EXPAND, getNeighbors(index, neighbors));
+            for (int i = 0; i < count; i++) {
+                if (PUZZLE_TIMED(PHASE_HASH_INSERT, visited.insert(neighbors[i].board.cells))) {
+                    PUZZLE_TIMED(PHASE_ALLOC, nodes.push(neighbors[i]));
+                }
+            }
+        }
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        execution_time = duration.count() / 1000.0;
+        return SOLUTION_LIMIT; // No solution found within limits
+    }
+    
+    int getNodesExpanded() const {
+        return total_nodes_expanded;
+    }
+    
+    // Moves of the blank for the last solved puzzle, empty if none
+    std::string getPath() const {
+        if (solution_node == NO_PARENT) return "";
+        return pathToString(nodes.pathTo(solution_node));
+    }
+    
+    TableStats getTableStats() const {
+        return visited.stats();
+    }
+};
+
+/**
+ * @brief Bidirectional BFS: layers grow from the start and from the goal
+ *
+ * Each step expands one whole layer of the side with the smaller frontier.
+ * When a child is already known to the other side, the path through it costs
+ * d_this + 1 + d_other; after finishing that layer the minimum over all such
+ * meetings is optimal, since no shorter path met in an earlier layer. The two
+ * balls have radius about d/2 each, instead of one ball of radius d.
+ */
+template <typename Word, int Side = 0>
+class BiBFS_NSize {
+private:
+    // One search direction: its nodes, a board -> node index map and the frontier
+    struct Direction {
+        NodeArena<BfsNode<Word> > nodes;
+        StateTable<Word, uint32_t> index;
+        std::vector<uint32_t> layer;
+        int depth;
+        
+        explicit Direction(size_t max_entries) : index(max_entries), depth(0) {}
+        
+        void start(const PackedBoard<Word>& board) {
+            nodes.reset();
+            index.clear();
+            BfsNode<Word> root;
+            root.board = board;
+            index.insert(board.cells, nodes.push(root));
+            layer.assign(1, 0);
+            depth = 0;
+        }
+    };
+    
+    BoardDim<Side> N;
+    PackedBoard<Word> goal;
+    int total_nodes_expanded;
+    MoveTable moves;
+    
+    // Shared by both directions, same limit as BFS_NSize
+    static const int MAX_STATES = 1000000;
+    Direction forward, backward;
+    std::vector<uint32_t> next_layer;
+    int best_cost;
+    uint32_t meet_forward, meet_backward;   // node indices of the best meeting
+    
+    // Expands the whole current layer of `own`, recording meetings with `other`
+    void expandLayer(Direction& own, Direction& other) {
+        next_layer.clear();
+        
+        for (size_t i = 0; i < own.layer.size(); i++) {
+            PUZZLE_SCOPE(PHASE_EXPAND);
+            uint32_t parent = own.layer[i];
+            BfsNode<Word> current = own.nodes[parent];
+            total_nodes_expanded++;
+            const BlankMoves& legal = moves.at(current.board.blank);
+            
+            for (int k = 0; k < legal.count; k++) {
+                if (undoes(legal.move[k], current.move)) continue;
+                
+                BfsNode<Word> neighbor = current;
+                neighbor.board.slide(legal.target[k]);
+                neighbor.g = current.g + 1;
+                neighbor.parent = parent;
+                neighbor.move = static_cast<uint8_t>(legal.move[k]);
+                uint32_t child = static_cast<uint32_t>(own.nodes.size());
+                if (!PUZZLE_TIMED(PHASE_HASH_INSERT, own.index.insert(neighbor.board.cells, child))) continue;
+                PUZZLE_TIMED(PHASE_ALLOC, own.nodes.push(neighbor));
+                
+                uint32_t* met = PUZZLE_TIMED(PHASE_HASH_LOOKUP, other.index.find(neighbor.board.cells));
+                if (met != nullptr) {
+                    int cost = neighbor.g + other.nodes[*met].g;
+                    if (best_cost < 0 || cost < best_cost) {
+                        best_cost = cost;
+                        meet_forward = (&own == &forward) ? child : *met;
+                        meet_backward = (&own == &forward) ? *met : child;
+                    }
+                } else {
+                    next_layer.push_back(child);
+                }
+            }
+        }
+        own.layer.swap(next_layer);
+        own.depth++;
+    }
+    
+public:
+    BiBFS_NSize(int size)
+        : N(size), goal(goalBoard<Word>(size)), total_nodes_expanded(0), moves(size),
+          forward(MAX_STATES / 2), backward(MAX_STATES / 2), best_cost(-1),
+          meet_forward(NO_PARENT), meet_backward(NO_PARENT) {}
+    
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        forward.start(initial);
+        backward.start(goal);
+        total_nodes_expanded = 0;
+        best_cost = -1;
+        meet_forward = meet_backward = NO_PARENT;
+        
+        if (initial == goal) {
+            best_cost = 0;
+            meet_forward = meet_backward = 0;
+        }
+        
+        while (best_cost < 0 && !forward.layer.empty() && !backward.layer.empty() &&
+               forward.index.size() + backward.index.size() < static_cast<size_t>(MAX_STATES)) {
+            if (forward.layer.size() <= backward.layer.size()) {
+                expandLayer(forward, backward);
+            } else {
+                expandLayer(backward, forward);
+            }
+        }
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        execution_time = duration.count() / 1000.0;
+        return best_cost;
+    }
+    
+    int getNodesExpanded() const {
+        return total_nodes_expanded;
+    }
+    
+    // Start -> meeting along forward links, then meeting -> goal by undoing backward moves
+    std::string getPath() const {
+        if (best_cost < 0) return "";
+        std::vector<int> moves = forward.nodes.pathTo(meet_forward);
+        for (uint32_t node = meet_backward; backward.nodes[node].parent != NO_PARENT;
+             node = backward.nodes[node].parent) {
+            moves.push_back(oppositeMove(backward.nodes[node].move));
+        }
+        return pathToString(moves);
+    }
+    
+    // Both directions combined
+    TableStats getTableStats() const {
+        TableStats f = forward.index.stats(), b = backward.index.stats();
+        f.size += b.size;
+        f.capacity += b.capacity;
+        f.operations += b.operations;
+        f.probes += b.probes;
+        if (b.max_probe > f.max_probe) f.max_probe = b.max_probe;
+        return f;
+    }
+};
+
+// Same interface as BFS_NSize; each BFS layer is expanded by several threads
+class LevelBFS_NSize {
+private:
+    static const int MAX_STATES = 1000000;
+    LevelBFS engine;
+    PackedBoard<uint64_t> goal;
+    
+public:
+    LevelBFS_NSize(int size, int threads) : engine(size, threads, MAX_STATES), goal(goalBoard<uint64_t>(size)) {}
+    
+    int solve(const PackedBoard<uint64_t>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        int result = engine.solve(initial, goal);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        execution_time = duration.count() / 1000.0;
+        return result;
+    }
+    
+    int getNodesExpanded() const {
+        return static_cast<int>(engine.nodesExpanded());
+    }
+    
+    // Layers keep no parent links; callers reject --paths for this solver
+    std::string getPath() const {
+        return "";
+    }
+    
+    // The concurrent set keeps no probe counters
+    TableStats getTableStats() const {
+        TableStats ts = TableStats();
+        ts.size = engine.statesVisited();
+        ts.capacity = engine.tableCapacity();
+        return ts;
+    }
+};
+
+} // namespace puzzle
+
+#endif // BFS_SEARCH_H
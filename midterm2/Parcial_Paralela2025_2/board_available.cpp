@@ -25,6 +25,8 @@ using namespace std;
 #include <iostream>
 #include <string>
 
+#include "move_tables.h"
+
 using namespace std;
 
 /**
@@ -43,24 +45,13 @@ void listAvailable(int n, const string& board) {
         }
     }
     
-    if (blank_pos == -1) return; // No blank found
-    
-    // Convert 1D position to 2D coordinates
-    int row = blank_pos / n;
-    int col = blank_pos % n;
+    if (blank_pos == -1 || blank_pos >= n * n) return; // No blank found
     
-    // Check each direction in order: UP, DOWN, LEFT, RIGHT
-    if (row > 0) {           // UP is possible
-        cout << "UP" << endl;
-    }
-    if (row < n - 1) {       // DOWN is possible
-        cout << "DOWN" << endl;
-    }
-    if (col > 0) {           // LEFT is possible
-        cout << "LEFT" << endl;
-    }
-    if (col < n - 1) {       // RIGHT is possible
-        cout << "RIGHT" << endl;
+    // Legal moves in order UP, DOWN, LEFT, RIGHT, from the table the solvers use
+    puzzle::MoveTable moves(n);
+    const puzzle::BlankMoves& legal = moves.at(blank_pos);
+    for (int k = 0; k < legal.count; k++) {
+        cout << puzzle::moveName(legal.move[k]) << endl;
     }
 }
 /**
@@ -3,16 +3,27 @@
 
 #include <bits/stdc++.h>
 #include <omp.h>
+#include "puzzle_board.h"
+#include "state_table.h"
+#include "level_bfs.h"
+#include "heuristics.h"
+#include "move_tables.h"
+#include "work_stealing.h"
+#include "batch_pipeline.h"
+#include "instrumentation.h"
 using namespace std;
 
-const int dRow[] = {-1, 1, 0, 0};
-const int dCol[] = {0, 0, -1, 1};
+const int MAX_STATES = 1000000;
+const int MAX_QUEUE = 200000;
+const int BOARD_SIDE = 4;   // batches are 4x4, loaded or streamed
+
+typedef puzzle::PackedBoard<uint64_t> Board;
 
 struct State {
-    string board;
-    int blankPos;
+    Board board;
     int cost;
-    State(const string& b, int pos, int c) : board(b), blankPos(pos), cost(c) {}
+    int move;   // blank move that produced this state, MOVE_NONE for the start
+    State(const Board& b, int c, int m) : board(b), cost(c), move(m) {}
 };
 
 struct PuzzleResult {
@@ -20,60 +31,32 @@ struct PuzzleResult {
     int solution;
     int nodesExpanded;
     double executionTimeMs; // per-puzzle elapsed wall time in ms
-    int threadId;
+    int threadId;                    // -1: all threads worked on it, or the pre-filter answered
+    vector<long long> nodesByThread; // per-thread expansions, --intra-bfs only
 };
 
-// Helper: generate goal like "A...#"
-string generateGoalState(int n) {
-    string goal;
-    char c = 'A';
-    for (int i = 0; i < n*n - 1; ++i) {
-        goal.push_back(c++);
-        if (c > 'Z') c = 'A'; // unlikely for small n
-    }
-    goal.push_back('#');
-    return goal;
-}
-
-string swapBoardTiles(const string& currentBoard, int p1, int p2) {
-    string nb = currentBoard;
-    swap(nb[p1], nb[p2]);
-    return nb;
-}
-
-bool isSolvable(int n, const string& board) {
-    int inversions = 0;
-    int blankRow = 0;
-    for (size_t i = 0; i < board.size(); ++i) {
-        if (board[i] == '#') { blankRow = i / n; continue; }
-        for (size_t j = i+1; j < board.size(); ++j)
-            if (board[j] != '#' && board[i] > board[j]) inversions++;
-    }
-    if (n % 2 == 1) return (inversions % 2 == 0);
-    else {
-        if ((n - blankRow) % 2 == 0) return (inversions % 2 == 1);
-        else return (inversions % 2 == 0);
-    }
-}
-
-// BFS per puzzle: returns moves (or -1) and sets nodesExpanded
+// BFS per puzzle: returns moves (-1 past the limits or invalid, -2 unsolvable)
+// and sets nodesExpanded
 pair<int,int> bfsSolver(int n, const string& start) {
-    string goal = generateGoalState(n);
-    if (start == goal) return {0,0};
-    if (!isSolvable(n, start)) return {-1,0};
+    Board startBoard;
+    if (!puzzle::parseBoard(start, n, startBoard)) return {-1,0};
+    Board goal = puzzle::goalBoard<uint64_t>(n);
+    if (startBoard == goal) return {0,0};
+    if (!puzzle::isSolvable(startBoard, n)) return {puzzle::SOLUTION_UNSOLVABLE, 0};
 
-    queue<State> q;
-    unordered_set<string> visited;
-    int blankPos = start.find('#');
-    q.push(State(start, blankPos, 0));
-    visited.insert(start);
+    // One table per thread, sized for the limits above and reused across puzzles
+    static thread_local puzzle::StateTable<uint64_t> visited(MAX_STATES + MAX_QUEUE);
+    visited.clear();
+    const puzzle::MoveTable& moves = puzzle::moveTableFor(n);
 
-    const int MAX_STATES = 1000000;
-    const int MAX_QUEUE = 200000;
+    queue<State> q;
+    q.push(State(startBoard, 0, puzzle::MOVE_NONE));
+    visited.insert(startBoard.cells);
     int nodesExpanded = 0;
     int statesExplored = 0;
 
     while (!q.empty() && statesExplored < MAX_STATES) {
+        PUZZLE_SCOPE(puzzle::PHASE_EXPAND);
         State cur = q.front(); q.pop();
         statesExplored++;
         nodesExpanded++;
@@ -81,17 +64,13 @@ pair<int,int> bfsSolver(int n, const string& start) {
         if (cur.board == goal) return {cur.cost, nodesExpanded};
         if ((int)q.size() > MAX_QUEUE) return {-1, nodesExpanded};
 
-        int row = cur.blankPos / n;
-        int col = cur.blankPos % n;
-        for (int k = 0; k < 4; ++k) {
-            int nr = row + dRow[k], nc = col + dCol[k];
-            if (nr >= 0 && nr < n && nc >= 0 && nc < n) {
-                int newPos = nr * n + nc;
-                string nb = swapBoardTiles(cur.board, cur.blankPos, newPos);
-                if (visited.find(nb) == visited.end()) {
-                    visited.insert(nb);
-                    q.push(State(nb, newPos, cur.cost+1));
-                }
+        const puzzle::BlankMoves& legal = moves.at(cur.board.blank);
+        for (int k = 0; k < legal.count; ++k) {
+            if (puzzle::undoes(legal.move[k], cur.move)) continue;
+            Board nb = cur.board;
+            nb.slide(legal.target[k]);
+            if (PUZZLE_TIMED(puzzle::PHASE_HASH_INSERT, visited.insert(nb.cells))) {
+                PUZZLE_TIMED(puzzle::PHASE_ALLOC, q.push(State(nb, cur.cost+1, legal.move[k])));
             }
         }
     }
@@ -107,35 +86,198 @@ pair<vector<PuzzleResult>, double> processSequential(const vector<pair<int,strin
         double s = omp_get_wtime();
         auto pr = bfsSolver(puzzles[i].first, puzzles[i].second);
         double elapsed_ms = (omp_get_wtime() - s) * 1000.0;
-        results.push_back({(int)i, pr.first, pr.second, elapsed_ms, 0});
+        results.push_back({(int)i, pr.first, pr.second, elapsed_ms, 0, {}});
     }
     double total_ms = (omp_get_wtime() - t0) * 1000.0;
     return {results, total_ms};
 }
 
-// Process parallel with dynamic scheduling and aggregate results after
-pair<vector<PuzzleResult>, double> processParallel(const vector<pair<int,string>>& puzzles, int numThreads) {
+// Pre-filter stage, one parallel pass over the whole batch: boards with the
+// wrong parity are answered here and never scheduled; the rest get a cheap
+// hardness estimate (Manhattan distance) to order the batch. With dedupe,
+// repeats of an earlier board or of its diagonal mirror (same distance, see
+// puzzle_board.h) are not scheduled either and copy its answer.
+struct Prefilter {
+    vector<char> unsolvable;
+    vector<int> hardness;
+    vector<int> duplicateOf;   // index of the first copy of the board, -1 for first copies
+};
+
+Prefilter prefilterBatch(const vector<pair<int,string>>& puzzles, int numThreads, bool dedupe) {
+    Prefilter pf;
+    pf.unsolvable.assign(puzzles.size(), 0);
+    pf.hardness.assign(puzzles.size(), 0);
+    pf.duplicateOf.assign(puzzles.size(), -1);
+    vector<uint64_t> cells(puzzles.size(), 0);   // 0: invalid board, never deduped
+    // One distance table per board side, shared: initial() is const
+    map<int, puzzle::ManhattanHeuristic<uint64_t>> manhattan;
+    for (const auto& p : puzzles) {
+        if (puzzle::fitsBoard<uint64_t>(p.first) && !manhattan.count(p.first)) {
+            manhattan.emplace(p.first, puzzle::ManhattanHeuristic<uint64_t>(p.first));
+        }
+    }
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (long long i = 0; i < (long long)puzzles.size(); ++i) {
+        int n = puzzles[i].first;
+        Board b;
+        if (!puzzle::parseBoard(puzzles[i].second, n, b)) continue;   // bfsSolver reports it
+        if (!puzzle::isSolvable(b, n)) {
+            pf.unsolvable[i] = 1;
+            continue;
+        }
+        pf.hardness[i] = manhattan.find(n)->second.initial(b);
+        bool mirrored;
+        cells[i] = puzzle::canonicalBoard(b, n, mirrored).cells;
+    }
+    if (dedupe) {
+        unordered_map<uint64_t, int, puzzle::PackedHash> first;
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            if (cells[i] == 0) continue;
+            auto it = first.insert({cells[i], (int)i}).first;
+            if (it->second != (int)i) pf.duplicateOf[i] = it->second;
+        }
+    }
+    return pf;
+}
+
+struct ScheduleReport {
+    vector<puzzle::WorkerStats> workers;
+    double tailLatencyMs;
+    size_t totalSteals;
+    size_t prefiltered;   // unsolvable boards answered before scheduling
+    size_t duplicates;    // repeated boards answered by their first copy (--dedupe)
+};
+
+// Process parallel with a work-stealing scheduler, hardest puzzles first
+pair<vector<PuzzleResult>, double> processParallel(const vector<pair<int,string>>& puzzles, int numThreads,
+                                                   bool dedupe, ScheduleReport& report) {
     vector<PuzzleResult> results(puzzles.size());
-    omp_set_num_threads(numThreads);
 
     double wall0 = omp_get_wtime();
+    Prefilter pf = prefilterBatch(puzzles, numThreads, dedupe);
+    vector<int> order;
+    report.prefiltered = 0;
+    report.duplicates = 0;
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        if (pf.unsolvable[i]) {
+            results[i] = {(int)i, puzzle::SOLUTION_UNSOLVABLE, 0, 0.0, -1, {}};
+            report.prefiltered++;
+        } else if (pf.duplicateOf[i] >= 0) {
+            report.duplicates++;
+        } else {
+            order.push_back((int)i);
+        }
+    }
+    const vector<int>& hardness = pf.hardness;
+    stable_sort(order.begin(), order.end(), [&hardness](int a, int b) { return hardness[a] > hardness[b]; });
+
+    puzzle::WorkStealingScheduler scheduler(numThreads, order);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        scheduler.run(omp_get_thread_num(), [&](int i, int tid) {
+            double s = omp_get_wtime();
+            auto pr = bfsSolver(puzzles[i].first, puzzles[i].second);
+            double elapsed_ms = (omp_get_wtime() - s) * 1000.0;
+            results[i] = {i, pr.first, pr.second, elapsed_ms, tid, {}};
+        });
+    }
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        if (pf.duplicateOf[i] >= 0) results[i] = {(int)i, results[pf.duplicateOf[i]].solution, 0, 0.0, -1, {}};
+    }
+
+    double wall_ms = (omp_get_wtime() - wall0) * 1000.0;
+    report.workers = scheduler.stats();
+    report.tailLatencyMs = scheduler.tailLatencyMs();
+    report.totalSteals = scheduler.totalSteals();
+    return {results, wall_ms};
+}
+
+// Process puzzles one at a time, every BFS layer expanded by all threads
+pair<vector<PuzzleResult>, double> processIntraPuzzle(const vector<pair<int,string>>& puzzles, int numThreads) {
+    vector<PuzzleResult> results;
+    results.reserve(puzzles.size());
+    map<int, unique_ptr<puzzle::LevelBFS>> engines;   // one per board size, reused
 
-    #pragma omp parallel for schedule(dynamic,1)
-    for (int i = 0; i < (int)puzzles.size(); ++i) {
-        int tid = omp_get_thread_num();
+    double wall0 = omp_get_wtime();
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        int n = puzzles[i].first;
         double s = omp_get_wtime();
-        auto pr = bfsSolver(puzzles[i].first, puzzles[i].second);
-        double elapsed_ms = (omp_get_wtime() - s) * 1000.0;
-        results[i] = {(int)i, pr.first, pr.second, elapsed_ms, tid};
+        PuzzleResult r = {(int)i, -1, 0, 0.0, -1, vector<long long>(numThreads, 0)};
+        Board start;
+        if (puzzle::parseBoard(puzzles[i].second, n, start)) {
+            Board goal = puzzle::goalBoard<uint64_t>(n);
+            if (start == goal) {
+                r.solution = 0;
+            } else if (!puzzle::isSolvable(start, n)) {
+                r.solution = puzzle::SOLUTION_UNSOLVABLE;
+            } else {
+                auto& engine = engines[n];
+                if (!engine) engine.reset(new puzzle::LevelBFS(n, numThreads, MAX_STATES, MAX_QUEUE));
+                r.solution = engine->solve(start, goal);
+                r.nodesExpanded = (int)engine->nodesExpanded();
+                r.nodesByThread = engine->nodesPerThread();
+            }
+        }
+        r.executionTimeMs = (omp_get_wtime() - s) * 1000.0;
+        results.push_back(r);
     }
 
     double wall_ms = (omp_get_wtime() - wall0) * 1000.0;
     return {results, wall_ms};
 }
 
+// Streams the file through a bounded pipeline: nothing is kept per puzzle, so
+// memory does not grow with the batch (no sequential baseline, no sorting)
+int processStreaming(const string& filename, int n, const string& csvName, int numThreads, bool ordered) {
+    puzzle::ChunkedLineReader reader(filename);
+    if (!reader.ok()) {
+        cerr << "Cannot open file: " << filename << "\n";
+        return 1;
+    }
+    puzzle::BufferedWriter out(csvName);
+    if (!out.ok()) {
+        cerr << "Cannot write file: " << csvName << "\n";
+        return 1;
+    }
+    out.write("puzzle_index,thread_id,solution,nodes_expanded,per_puzzle_ms,threads_used\n");
+
+    const size_t CHUNK_LINES = 64;   // small: one hard board must not hold up a whole batch slice
+    puzzle::StreamPipeline pipeline(numThreads, CHUNK_LINES, 0, ordered);
+    puzzle::PipelineStats stats = pipeline.run(reader, out,
+        [n, numThreads](const puzzle::PuzzleLine& p, int tid, string& rows) {
+            double s = omp_get_wtime();
+            auto pr = bfsSolver(n, p.board);
+            double elapsed_ms = (omp_get_wtime() - s) * 1000.0;
+            char row[128];
+            snprintf(row, sizeof(row), "%lld,%d,%d,%d,%g,%d\n",
+                     p.index, tid, pr.first, pr.second, elapsed_ms, numThreads);
+            rows += row;
+        });
+    if (!out.close()) {
+        cerr << "Cannot write file: " << csvName << "\n";
+        return 1;
+    }
+
+    cout << fixed << setprecision(3);
+    cout << "\n=== STREAMING SUMMARY ===\n";
+    cout << "Puzzles: " << stats.boards << " in " << stats.chunks << " chunks of <= " << CHUNK_LINES << "\n";
+    cout << "Threads: " << numThreads << " solvers (+ reader, writer)\n";
+    cout << "Output order: " << (ordered ? "input order" : "completion order") << "\n";
+    cout << "Wall time (ms): " << stats.wall_ms << "\n";
+    cout << "Throughput (puzzles/s): " << (stats.wall_ms > 0 ? stats.boards / (stats.wall_ms / 1000.0) : 0.0) << "\n";
+    if (ordered) cout << "Peak chunks waiting for their turn: " << stats.peak_buffered << "\n";
+    for (int t = 0; t < numThreads; ++t) {
+        cout << "Thread " << t << ": puzzles=" << stats.boards_per_worker[t] << "\n";
+    }
+    cerr << "Wrote CSV: " << csvName << "\n";
+    return 0;
+}
+
 void printSummaryAndCSV(const vector<PuzzleResult>& seq, double seqWallMs,
                         const vector<PuzzleResult>& par, double parWallMs,
-                        int numThreads, const string& csvName = "parallel_results_fixed.csv")
+                        int numThreads, const ScheduleReport* schedule = nullptr,
+                        const string& csvName = "parallel_results_fixed.csv")
 {
     // Totals
     long long seqNodes = 0, parNodes = 0;
@@ -162,16 +304,35 @@ void printSummaryAndCSV(const vector<PuzzleResult>& seq, double seqWallMs,
     vector<long long> nodesPerThread(numThreads, 0);
     vector<double> timePerThreadMs(numThreads, 0.0);
     for (auto &r : par) {
+        for (int t = 0; t < (int)r.nodesByThread.size() && t < numThreads; ++t) {
+            nodesPerThread[t] += r.nodesByThread[t];
+            timePerThreadMs[t] += r.executionTimeMs;
+        }
         if (r.threadId >=0 && r.threadId < numThreads) {
             nodesPerThread[r.threadId] += r.nodesExpanded;
             timePerThreadMs[r.threadId] += r.executionTimeMs;
         }
     }
 
+    if (schedule != nullptr) {
+        cout << "\n=== SCHEDULER (work stealing, Manhattan hardest first) ===\n";
+        cout << "Unsolvable (pre-filtered): " << schedule->prefiltered << "\n";
+        cout << "Duplicates (solved once): " << schedule->duplicates << "\n";
+        cout << "Total steals: " << schedule->totalSteals << "\n";
+        cout << "Tail latency (ms): " << schedule->tailLatencyMs
+             << "  (first idle thread -> batch end)\n";
+    }
+
     cout << "\n=== NODES PER THREAD ===\n";
     for (int t = 0; t < numThreads; ++t) {
         cout << "Thread " << t << ": nodes=" << nodesPerThread[t]
-             << ", sum_puzzle_ms=" << timePerThreadMs[t] << "\n";
+             << ", sum_puzzle_ms=" << timePerThreadMs[t];
+        if (schedule != nullptr && t < (int)schedule->workers.size()) {
+            const puzzle::WorkerStats& w = schedule->workers[t];
+            cout << ", puzzles=" << w.tasks << ", steals=" << w.steals
+                 << ", idle_ms=" << w.idle_ms;
+        }
+        cout << "\n";
     }
 
     // Write CSV (parallel results)
@@ -185,16 +346,54 @@ void printSummaryAndCSV(const vector<PuzzleResult>& seq, double seqWallMs,
     cerr << "Wrote CSV: " << csvName << "\n";
 }
 
+// --profile: phase counters of every thread that searched, sequential
+// baseline included (see instrumentation.h)
+int writeProfileFile(const string& profileFile) {
+    if (profileFile.empty()) return 0;
+    if (!puzzle::writeProfile(profileFile)) {
+        cerr << "Cannot write file: " << profileFile << "\n";
+        return 1;
+    }
+    cerr << "Wrote profile: " << profileFile << "\n";
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
-        cerr << "Usage: " << argv[0] << " <puzzles_file> <num_threads>\n";
+    bool intraBfs = false;
+    bool unordered = false;
+    bool dedupe = false;
+    string streamCsv;
+    string profileFile;
+    bool badArgs = argc < 3;
+    for (int i = 3; i < argc && !badArgs; ++i) {
+        string arg = argv[i];
+        if (arg == "--intra-bfs") intraBfs = true;
+        else if (arg == "--unordered") unordered = true;
+        else if (arg == "--dedupe") dedupe = true;
+        else if (arg == "--profile" && i + 1 < argc) profileFile = argv[++i];
+        else if (arg == "--stream" && i + 1 < argc) streamCsv = argv[++i];
+        else badArgs = true;
+    }
+    if (badArgs || (!streamCsv.empty() && intraBfs) || (unordered && streamCsv.empty()) ||
+        (dedupe && (intraBfs || !streamCsv.empty()))) {
+        cerr << "Usage: " << argv[0] << " <puzzles_file> <num_threads> [--dedupe | --intra-bfs | --stream <out.csv> [--unordered]]"
+             << " [--profile <phases.csv|.json>]\n";
+        return 1;
+    }
+    if (!profileFile.empty() && !puzzle::PROFILE_ENABLED) {
+        cerr << "Error: --profile needs a build with -DPUZZLE_PROFILE\n";
         return 1;
     }
     string filename = argv[1];
     int numThreads = atoi(argv[2]);
     if (numThreads <= 0) numThreads = 1;
 
-    // Read puzzles file (one board per line). Assumes 4x4 puzzles.
+    if (!streamCsv.empty()) {
+        int status = processStreaming(filename, BOARD_SIDE, streamCsv, numThreads, !unordered);
+        return status == 0 ? writeProfileFile(profileFile) : status;
+    }
+
+    // Read puzzles file (one board per line) of BOARD_SIDE x BOARD_SIDE boards
     vector<pair<int,string>> puzzles;
     ifstream fin(filename);
     if (!fin) {
@@ -207,7 +406,7 @@ int main(int argc, char* argv[]) {
         // Trim whitespace
         string s;
         for (char c : line) if (!isspace((unsigned char)c)) s.push_back(c);
-        if (!s.empty()) puzzles.push_back({4, s});
+        if (!s.empty()) puzzles.push_back({BOARD_SIDE, s});
     }
     fin.close();
 
@@ -223,13 +422,15 @@ int main(int argc, char* argv[]) {
     auto seqResults = seqPair.first;
     double seqWallMs = seqPair.second;
 
-    // Parallel
-    auto parPair = processParallel(puzzles, numThreads);
+    // Parallel: across puzzles, or inside each puzzle's BFS layers
+    if (intraBfs) cout << "Parallel mode: level-synchronous BFS inside each puzzle\n";
+    ScheduleReport schedule;
+    auto parPair = intraBfs ? processIntraPuzzle(puzzles, numThreads) : processParallel(puzzles, numThreads, dedupe, schedule);
     auto parResults = parPair.first;
     double parWallMs = parPair.second;
 
     // Print summary and save CSV
-    printSummaryAndCSV(seqResults, seqWallMs, parResults, parWallMs, numThreads);
+    printSummaryAndCSV(seqResults, seqWallMs, parResults, parWallMs, numThreads, intraBfs ? nullptr : &schedule);
 
-    return 0;
+    return writeProfileFile(profileFile);
 }
@@ -0,0 +1,222 @@
+/**
+ * @file eight_puzzle_table.h
+ * @brief Distance to the goal of every solvable 3x3 board, and a solver that looks it up
+ *
+ * The 3x3 puzzle has 9!/2 = 181,440 solvable boards, few enough to solve all
+ * of them at once: one BFS backward from the goal fills a table with one byte
+ * per board, after which any 3x3 query is a single lookup and its solution a
+ * walk down the table.
+ *
+ * Boards are indexed by their rankEightPuzzle (permutation_rank.h), a perfect
+ * hash of the solvable boards, so the table needs no keys.
+ *
+ * Each entry holds the distance in its low 5 bits (at most 31 moves) and, in
+ * bits 5-6, a blank move that leads one step closer to the goal.
+ *
+ * File layout (host byte order): EightTableHeader, then one byte per index.
+ */
+#ifndef EIGHT_PUZZLE_TABLE_H
+#define EIGHT_PUZZLE_TABLE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "puzzle_board.h"
+#include "move_tables.h"
+#include "node_arena.h"
+#include "permutation_rank.h"
+
+namespace puzzle {
+
+static const uint8_t EIGHT_TABLE_UNSEEN = 0xFF;
+
+struct EightTableHeader {
+    char magic[4];       // "EPT1"
+    uint32_t version;    // 1
+    uint32_t n;          // 3
+    uint32_t states;     // EIGHT_PUZZLE_STATES
+};
+
+class EightPuzzleTable {
+private:
+    std::vector<uint8_t> entries_;
+
+    /**
+     * @brief True if every entry is reached and its move leads one step closer to the goal
+     *
+     * Only the goal may have distance 0, bit 7 must be clear, and from every
+     * other board the stored move must be legal and land on an entry one less
+     * away, so solve() and getPath() can trust whatever a file holds.
+     */
+    static bool consistent(const std::vector<uint8_t>& entries) {
+        const MoveTable& moves = moveTableFor(3);
+        uint32_t goal = rankEightPuzzle(goalBoard<uint64_t>(3).cells);
+        for (uint32_t index = 0; index < EIGHT_PUZZLE_STATES; index++) {
+            uint8_t entry = entries[index];
+            int distance = entry & 0x1F;
+            if ((entry & 0x80) != 0 || (distance == 0) != (index == goal)) return false;
+            if (distance == 0) continue;
+            PackedBoard<uint64_t> board = unrankEightPuzzle<uint64_t>(index);
+            const BlankMoves& legal = moves.at(board.blank);
+            int k = 0;
+            while (k < legal.count && legal.move[k] != (entry >> 5)) k++;
+            if (k == legal.count) return false;
+            board.slide(legal.target[k]);
+            if ((entries[rankEightPuzzle(board.cells)] & 0x1F) != distance - 1) return false;
+        }
+        return true;
+    }
+
+public:
+    bool ready() const { return entries_.size() == EIGHT_PUZZLE_STATES; }
+
+    /**
+     * @brief Fills the table by BFS backward from the goal
+     *
+     * The table itself is the frontier: layer d is every entry at distance d,
+     * found by a scan and unranked back into a board, so the search needs no
+     * queue on top of the one byte per state.
+     */
+    void build() {
+        entries_.assign(EIGHT_PUZZLE_STATES, EIGHT_TABLE_UNSEEN);
+        const MoveTable& moves = moveTableFor(3);
+        entries_[rankEightPuzzle(goalBoard<uint64_t>(3).cells)] = 0;
+
+        for (int distance = 0;; distance++) {
+            bool grew = false;
+            for (uint32_t index = 0; index < EIGHT_PUZZLE_STATES; index++) {
+                if (entries_[index] == EIGHT_TABLE_UNSEEN || (entries_[index] & 0x1F) != distance) continue;
+                PackedBoard<uint64_t> board = unrankEightPuzzle<uint64_t>(index);
+                const BlankMoves& legal = moves.at(board.blank);
+                for (int k = 0; k < legal.count; k++) {
+                    PackedBoard<uint64_t> child = board;
+                    child.slide(legal.target[k]);
+                    uint8_t& entry = entries_[rankEightPuzzle(child.cells)];
+                    if (entry != EIGHT_TABLE_UNSEEN) continue;
+                    // From the child, the opposite move returns to `board`
+                    entry = static_cast<uint8_t>((distance + 1) | (oppositeMove(legal.move[k]) << 5));
+                    grew = true;
+                }
+            }
+            if (!grew) return;
+        }
+    }
+
+    /**
+     * @brief Reads a table written by save(); false with @p error on a bad or corrupt file
+     */
+    bool load(const std::string& path, std::string& error) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            error = "cannot open " + path;
+            return false;
+        }
+        EightTableHeader header;
+        std::vector<uint8_t> entries(EIGHT_PUZZLE_STATES);
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, "EPT1", 4) == 0 &&
+                  header.version == 1 && header.n == 3 && header.states == EIGHT_PUZZLE_STATES &&
+                  std::fread(entries.data(), 1, entries.size(), file) == entries.size();
+        std::fclose(file);
+        if (!ok) {
+            error = path + " is not an EPT1 3x3 table";
+            return false;
+        }
+        if (!consistent(entries)) {
+            error = path + " has corrupt entries";
+            return false;
+        }
+        entries_.swap(entries);
+        return true;
+    }
+
+    bool save(const std::string& path, std::string& error) const {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            error = "cannot write " + path;
+            return false;
+        }
+        EightTableHeader header;
+        memcpy(header.magic, "EPT1", 4);
+        header.version = 1;
+        header.n = 3;
+        header.states = EIGHT_PUZZLE_STATES;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(entries_.data(), 1, entries_.size(), file) == entries_.size();
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) error = "cannot write " + path;
+        return ok;
+    }
+
+    /**
+     * @brief Loads @p path, or builds the table and saves it there if the file does not exist yet
+     */
+    bool loadOrBuild(const std::string& path, std::string& error) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file != nullptr) {
+            std::fclose(file);
+            return load(path, error);
+        }
+        build();
+        return save(path, error);
+    }
+
+    int distance(uint32_t index) const { return entries_[index] & 0x1F; }
+    int nextMove(uint32_t index) const { return entries_[index] >> 5; }
+};
+
+/**
+ * @brief Solver interface over an EightPuzzleTable (3x3 boards only)
+ *
+ * solve() is one lookup and reports one node expanded; getPath() follows the
+ * stored moves down to the goal, one lookup per move.
+ */
+template <typename Word>
+class EightTableSolver {
+private:
+    const EightPuzzleTable* table_;
+    PackedBoard<Word> last_;
+    int last_length_;
+
+public:
+    explicit EightTableSolver(const EightPuzzleTable* table) : table_(table), last_length_(SOLUTION_LIMIT) {}
+
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        last_ = initial;
+        last_length_ = isSolvable(initial, 3) ? table_->distance(rankEightPuzzle(initial.cells))
+                                              : SOLUTION_UNSOLVABLE;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start_time);
+        execution_time = duration.count() / 1000.0;
+        return last_length_;
+    }
+
+    int getNodesExpanded() const {
+        return last_length_ >= 0 ? 1 : 0;
+    }
+
+    // Moves of the blank for the last solved puzzle, empty if none
+    std::string getPath() const {
+        if (last_length_ < 0) return "";
+        const MoveTable& moves = moveTableFor(3);
+        PackedBoard<Word> board = last_;
+        std::vector<int> path;
+        for (int step = 0; step < last_length_; step++) {
+            int move = table_->nextMove(rankEightPuzzle(board.cells));
+            const BlankMoves& legal = moves.at(board.blank);
+            for (int k = 0; k < legal.count; k++) {
+                if (legal.move[k] == move) board.slide(legal.target[k]);
+            }
+            path.push_back(move);
+        }
+        return pathToString(path);
+    }
+};
+
+} // namespace puzzle
+
+#endif // EIGHT_PUZZLE_TABLE_H
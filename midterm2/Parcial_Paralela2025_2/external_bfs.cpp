@@ -0,0 +1,129 @@
+/**
+ * @file external_bfs.cpp
+ * @brief BFS with its layers on disk: optimal solutions past the in-memory state limits
+ *
+ * The in-memory BFS solvers stop at MAX_STATES / MAX_QUEUE and report -1 for
+ * deep boards. This executable runs the external-memory search of
+ * external_bfs.h instead: layers are sorted files in a work directory and RAM
+ * use is bounded by --memory, so the depth it reaches depends on disk space.
+ *
+ * Solve mode reads a batch like the *_nsize solvers and writes the same CSV
+ * (or SPR1 with --bin-out); each board is searched from both ends. With
+ * --paths every layer is kept until the board is solved, so the moves can be
+ * recovered. --max-depth gives up (solution_length -1) on deeper boards.
+ *
+ * --distribution enumerates the layers from the goal and prints how many
+ * boards lie at each distance, up to --max-depth or the end of the state
+ * space (all 181,440 boards of the 3x3 take 32 layers).
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O3 -o external_bfs external_bfs.cpp
+ *
+ * Usage example:
+ *      ./external_bfs puzzles.txt 4 --dir /scratch --memory 2048
+ *      ./external_bfs --distribution 3
+ *      ./external_bfs --distribution 4 --max-depth 30 --dir /scratch --memory 4096
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "external_bfs.h"
+#include "batch_runner.h"
+
+using namespace std;
+using namespace puzzle;
+
+struct ExternalOptions {
+    string puzzles_file;
+    int n;
+    bool paths;
+    BatchFormat format;
+    ExternalBfsOptions search;
+};
+
+template <typename Word, int Side>
+struct SolveRun {
+    static bool run(const ExternalOptions& o) {
+        ifstream file(o.puzzles_file, ios::binary);
+        if (!file.is_open()) {
+            cerr << "Error: Cannot open file " << o.puzzles_file << endl;
+            return false;
+        }
+        ExternalBfsSolver<Word> solver(o.n, o.search);
+        if (!solver.ok()) {
+            cerr << "Error: " << solver.error() << endl;
+            return false;
+        }
+        bool ok = solveBatch<Word>(file, o.n, solver, "ExtBFS", o.paths, o.format, NoPuzzleHook());
+        if (!solver.ok()) {
+            cerr << "Error: " << solver.error() << endl;
+            return false;
+        }
+        return ok;
+    }
+};
+
+template <typename Word, int Side>
+struct DistributionRun {
+    static bool run(const ExternalOptions& o) {
+        ExternalBfs<Word> search(o.n, o.search);
+        auto start_time = chrono::steady_clock::now();
+        uint64_t total = 0;
+        vector<uint64_t> counts;
+        cout << "depth,states" << endl;
+        bool ok = search.distribution(o.search.max_depth, counts, [&](int depth, uint64_t count) {
+            total += count;
+            cout << depth << "," << count << endl;
+        });
+        if (!ok) {
+            cerr << "Error: " << search.error() << endl;
+            return false;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        cerr << "states=" << total << " layers=" << counts.size() << " expanded=" << search.nodesExpanded()
+             << " seconds=" << seconds << endl;
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    ExternalOptions options;
+    options.paths = false;
+    bool distribution = argc >= 2 && string(argv[1]) == "--distribution";
+    long long memory_mb = 256;
+    bool bad_args = argc < 3;
+    for (int i = 3; i < argc && !bad_args; i++) {
+        string arg = argv[i];
+        if (arg == "--paths" && !distribution) options.paths = true;
+        else if (arg == "--dir" && i + 1 < argc) options.search.dir = argv[++i];
+        else if (arg == "--memory" && i + 1 < argc) memory_mb = atoll(argv[++i]);
+        else if (arg == "--max-depth" && i + 1 < argc) options.search.max_depth = atoi(argv[++i]);
+        else if (arg == "--bin-in" && !distribution) options.format.binary_input = true;
+        else if (arg == "--bin-out" && i + 1 < argc && !distribution) options.format.results_file = argv[++i];
+        else bad_args = true;
+    }
+    if (bad_args || memory_mb < 1 || (options.paths && !options.format.results_file.empty())) {
+        cerr << "Usage: " << argv[0] << " <puzzles_file> <N_size> [--paths] [--bin-in] [--bin-out <results.spr>]"
+             << " [--dir <work_dir>] [--memory <MB>] [--max-depth <D>]\n"
+             << "       " << argv[0] << " --distribution <N_size> [--dir <work_dir>] [--memory <MB>]"
+             << " [--max-depth <D>]" << endl;
+        return 1;
+    }
+    options.puzzles_file = argv[1];
+    options.n = atoi(argv[2]);
+    options.search.memory_bytes = static_cast<size_t>(memory_mb) << 20;
+    options.search.keep_layers = options.paths;
+    if (!supportedBoardSize(options.n)) {
+        cerr << "Error: Unsupported board size " << options.n << " (supported: 2..5)" << endl;
+        return 1;
+    }
+
+    bool ok = distribution ? dispatchBoardSize<DistributionRun>(options.n, options)
+                           : dispatchBoardSize<SolveRun>(options.n, options);
+    return ok ? 0 : 1;
+}
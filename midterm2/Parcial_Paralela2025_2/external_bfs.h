@@ -0,0 +1,520 @@
+/**
+ * @file external_bfs.h
+ * @brief Breadth-first search with its layers on disk, for searches too large for RAM
+ *
+ * Every BFS layer is a file of packed boards in ascending order, without
+ * duplicates. Layer d+1 is built from layer d in two streaming passes:
+ *
+ *   1. Expand: read layer d in large blocks, append every child to a buffer
+ *      sized by the memory budget; when it is full, sort it, drop duplicates
+ *      and write it out as a sorted run.
+ *   2. Merge: k-way merge of the runs, dropping duplicates across runs and
+ *      every board of layer d-1, which is read alongside as a third sorted
+ *      stream. The result is layer d+1.
+ *
+ * Sliding-tile graphs are bipartite (every move flips the blank's colour on
+ * the checkerboard), so the children of layer d lie in layers d-1 and d+1
+ * only: the previous layer is the only one they have to be checked against,
+ * and older layers can be deleted. RAM use is the budget, whatever the size of
+ * the layers; disk use is about three layers plus the runs of the next one.
+ *
+ * Runs beyond the merge fan-in (the number of read buffers the budget holds)
+ * are merged in extra passes first. All file access is sequential in blocks,
+ * except the binary searches of path reconstruction.
+ *
+ * solve() searches from the board and from the goal at the same time,
+ * expanding the side with the smaller last layer. The merge that writes a new
+ * layer also streams the other side's last layer and reports the first board
+ * in both. The two depths only grow one step at a time, so the first such
+ * meeting is at the optimal depth (a shorter path would have met when the
+ * depths first summed to its length). With keep_layers, every layer stays on
+ * disk until the next solve and the path is rebuilt by binary searches for a
+ * parent in each earlier layer.
+ */
+#ifndef EXTERNAL_BFS_H
+#define EXTERNAL_BFS_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "puzzle_board.h"
+#include "move_tables.h"
+#include "node_arena.h"
+
+namespace puzzle {
+
+struct ExternalBfsOptions {
+    std::string dir;           // a private work directory is created inside it
+    size_t memory_bytes;       // budget for the sort buffer and the read/write blocks
+    int max_depth;             // solve(): SOLUTION_LIMIT past this depth (-1: no limit)
+    bool keep_layers;          // keep every layer, so getPath() can rebuild the solution
+
+    ExternalBfsOptions() : dir("."), memory_bytes(size_t(256) << 20), max_depth(-1), keep_layers(false) {}
+};
+
+/**
+ * @brief A sorted layer file and the number of boards in it
+ */
+struct LayerFile {
+    std::string path;
+    uint64_t count;
+
+    LayerFile() : count(0) {}
+};
+
+/**
+ * @brief Appends words to a file through a block buffer
+ */
+template <typename Word>
+class BlockWriter {
+private:
+    FILE* file_;
+    std::vector<Word> block_;
+    uint64_t written_;
+    bool ok_;
+
+    BlockWriter(const BlockWriter&);
+    BlockWriter& operator=(const BlockWriter&);
+
+    void flush() {
+        if (!block_.empty() && std::fwrite(block_.data(), sizeof(Word), block_.size(), file_) != block_.size()) {
+            ok_ = false;
+        }
+        block_.clear();
+    }
+
+public:
+    BlockWriter(const std::string& path, size_t block_words)
+        : file_(std::fopen(path.c_str(), "wb")), written_(0), ok_(file_ != nullptr) {
+        block_.reserve(block_words);
+    }
+
+    ~BlockWriter() { close(); }
+
+    void push(Word w) {
+        block_.push_back(w);
+        written_++;
+        if (block_.size() == block_.capacity()) flush();
+    }
+
+    uint64_t written() const { return written_; }
+
+    // False if any write failed (e.g. the disk is full)
+    bool close() {
+        if (file_ == nullptr) return ok_;
+        flush();
+        ok_ = std::fclose(file_) == 0 && ok_;
+        file_ = nullptr;
+        return ok_;
+    }
+};
+
+/**
+ * @brief Reads a file of words in blocks; head() is the next unread word
+ */
+template <typename Word>
+class BlockReader {
+private:
+    FILE* file_;
+    std::vector<Word> block_;
+    size_t pos_, end_;
+
+    BlockReader(const BlockReader&);
+    BlockReader& operator=(const BlockReader&);
+
+    void refill() {
+        end_ = file_ != nullptr ? std::fread(block_.data(), sizeof(Word), block_.size(), file_) : 0;
+        pos_ = 0;
+    }
+
+public:
+    BlockReader(const std::string& path, size_t block_words)
+        : file_(std::fopen(path.c_str(), "rb")), block_(block_words > 0 ? block_words : 1), pos_(0), end_(0) {
+        refill();
+    }
+
+    ~BlockReader() {
+        if (file_ != nullptr) std::fclose(file_);
+    }
+
+    bool opened() const { return file_ != nullptr; }
+    bool done() const { return pos_ == end_; }
+    Word head() const { return block_[pos_]; }
+
+    void advance() {
+        if (++pos_ == end_) refill();
+    }
+};
+
+template <typename Word>
+class ExternalBfs {
+private:
+    int n_;
+    ExternalBfsOptions options_;
+    const MoveTable& moves_;
+    std::string work_dir_;
+    std::string error_;
+    size_t block_words_;       // words per read/write block
+    size_t buffer_words_;      // words in the expansion sort buffer
+    size_t fan_in_;            // runs merged per pass
+    int next_file_;
+    long long expanded_;
+    std::vector<int> path_;
+
+    ExternalBfs(const ExternalBfs&);
+    ExternalBfs& operator=(const ExternalBfs&);
+
+    // Layers and runs alike: layer0, layer1, ... in the work directory
+    std::string newFile() {
+        return work_dir_ + "/layer" + std::to_string(next_file_++);
+    }
+
+    static int blankOf(Word cells, int cell_count) {
+        for (int pos = 0; pos < cell_count; pos++, cells >>= PackedBoard<Word>::kBits) {
+            if ((cells & PackedBoard<Word>::kMask) == 0) return pos;
+        }
+        return -1;
+    }
+
+    PackedBoard<Word> unpack(Word cells) const {
+        PackedBoard<Word> board;
+        board.cells = cells;
+        board.blank = blankOf(cells, n_ * n_);
+        return board;
+    }
+
+    bool writeLayer(const std::vector<Word>& sorted, LayerFile& layer) {
+        layer.path = newFile();
+        BlockWriter<Word> out(layer.path, block_words_);
+        for (Word w : sorted) out.push(w);
+        layer.count = out.written();
+        if (!out.close()) {
+            error_ = "cannot write " + layer.path;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeRun(std::vector<Word>& buffer, std::vector<std::string>& runs) {
+        std::sort(buffer.begin(), buffer.end());
+        buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+        LayerFile run;
+        if (!writeLayer(buffer, run)) return false;
+        runs.push_back(run.path);
+        buffer.clear();
+        return true;
+    }
+
+    /**
+     * @brief Merges sorted @p inputs into @p output, dropping duplicates and boards of @p subtract
+     *
+     * @p subtract and @p other may be empty paths. The first board also found
+     * in @p other is stored in @p meet.
+     */
+    bool merge(const std::vector<std::string>& inputs, const std::string& subtract, const std::string& other,
+               LayerFile& output, bool& met, Word& meet) {
+        typedef std::pair<Word, size_t> Head;
+        std::vector<BlockReader<Word>*> readers;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head> > heads;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            readers.push_back(new BlockReader<Word>(inputs[i], block_words_));
+            if (!readers.back()->done()) heads.push(Head(readers.back()->head(), i));
+        }
+        BlockReader<Word> minus(subtract, subtract.empty() ? 1 : block_words_);
+        BlockReader<Word> against(other, other.empty() ? 1 : block_words_);
+        bool opened = (subtract.empty() || minus.opened()) && (other.empty() || against.opened());
+        for (size_t i = 0; i < readers.size(); i++) opened = opened && readers[i]->opened();
+        if (!opened) {
+            for (size_t i = 0; i < readers.size(); i++) delete readers[i];
+            error_ = "cannot read a layer in " + work_dir_;
+            return false;
+        }
+
+        output.path = newFile();
+        BlockWriter<Word> out(output.path, block_words_);
+        bool have_last = false;
+        Word last = 0;
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            BlockReader<Word>& reader = *readers[head.second];
+            reader.advance();
+            if (!reader.done()) heads.push(Head(reader.head(), head.second));
+
+            Word w = head.first;
+            if (have_last && w == last) continue;
+            have_last = true;
+            last = w;
+            while (!minus.done() && minus.head() < w) minus.advance();
+            if (!minus.done() && minus.head() == w) continue;
+            out.push(w);
+            while (!against.done() && against.head() < w) against.advance();
+            if (!met && !against.done() && against.head() == w) {
+                met = true;
+                meet = w;
+            }
+        }
+        for (size_t i = 0; i < readers.size(); i++) delete readers[i];
+        output.count = out.written();
+        if (!out.close()) {
+            error_ = "cannot write " + output.path;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes the children of @p from minus @p previous as a new layer
+     */
+    bool expand(const LayerFile& from, const LayerFile* previous, const LayerFile* other, LayerFile& to,
+                bool& met, Word& meet) {
+        std::vector<std::string> runs;
+        std::vector<Word> buffer;
+        buffer.reserve(buffer_words_);
+        {
+            BlockReader<Word> in(from.path, block_words_);
+            for (; !in.done(); in.advance()) {
+                PackedBoard<Word> board = unpack(in.head());
+                const BlankMoves& legal = moves_.at(board.blank);
+                for (int k = 0; k < legal.count; k++) {
+                    PackedBoard<Word> child = board;
+                    child.slide(legal.target[k]);
+                    buffer.push_back(child.cells);
+                }
+                if (buffer.size() + 4 > buffer_words_ && !writeRun(buffer, runs)) return false;
+            }
+            expanded_ += static_cast<long long>(from.count);
+        }
+        if (!buffer.empty() && !writeRun(buffer, runs)) return false;
+        std::vector<Word>().swap(buffer);   // give the budget back to the merge
+
+        // Extra passes while there are more runs than read buffers
+        while (runs.size() > fan_in_) {
+            std::vector<std::string> group(runs.begin(), runs.begin() + fan_in_);
+            LayerFile merged;
+            bool unused_met = false;
+            Word unused_meet = 0;
+            if (!merge(group, "", "", merged, unused_met, unused_meet)) return false;
+            for (const std::string& run : group) std::remove(run.c_str());
+            runs.erase(runs.begin(), runs.begin() + fan_in_);
+            runs.push_back(merged.path);
+        }
+        bool ok = merge(runs, previous != nullptr ? previous->path : "", other != nullptr ? other->path : "",
+                        to, met, meet);
+        for (const std::string& run : runs) std::remove(run.c_str());
+        return ok;
+    }
+
+    // True if the sorted layer file holds @p w (binary search with pread)
+    bool layerContains(const LayerFile& layer, Word w) const {
+        int fd = open(layer.path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        uint64_t lo = 0, hi = layer.count;
+        bool found = false;
+        while (lo < hi && !found) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            Word value = 0;
+            if (pread(fd, &value, sizeof(Word), static_cast<off_t>(mid * sizeof(Word))) != (ssize_t)sizeof(Word)) break;
+            if (value == w) found = true;
+            else if (value < w) lo = mid + 1;
+            else hi = mid;
+        }
+        close(fd);
+        return found;
+    }
+
+    /**
+     * @brief Steps from @p board to a neighbour in @p layer; returns the blank's move, -1 if none
+     */
+    int stepInto(PackedBoard<Word>& board, const LayerFile& layer) const {
+        const BlankMoves& legal = moves_.at(board.blank);
+        for (int k = 0; k < legal.count; k++) {
+            PackedBoard<Word> next = board;
+            next.slide(legal.target[k]);
+            if (layerContains(layer, next.cells)) {
+                board = next;
+                return legal.move[k];
+            }
+        }
+        return -1;
+    }
+
+    // Start -> meeting point backwards through the forward layers, then on to the goal
+    void rebuildPath(Word meet, const std::vector<LayerFile>& forward, const std::vector<LayerFile>& backward) {
+        path_.clear();
+        PackedBoard<Word> board = unpack(meet);
+        for (size_t d = forward.size() - 1; d > 0; d--) {
+            int move = stepInto(board, forward[d - 1]);
+            if (move < 0) break;
+            path_.push_back(oppositeMove(move));
+        }
+        std::reverse(path_.begin(), path_.end());
+        board = unpack(meet);
+        for (size_t d = backward.size() - 1; d > 0; d--) {
+            int move = stepInto(board, backward[d - 1]);
+            if (move < 0) break;
+            path_.push_back(move);
+        }
+    }
+
+    void removeLayers(std::vector<LayerFile>& layers) {
+        for (const LayerFile& layer : layers) std::remove(layer.path.c_str());
+        layers.clear();
+    }
+
+public:
+    ExternalBfs(int n, const ExternalBfsOptions& options)
+        : n_(n), options_(options), moves_(moveTableFor(n)), next_file_(0), expanded_(0) {
+        size_t budget_words = std::max<size_t>(options.memory_bytes / sizeof(Word), 1 << 16);
+        block_words_ = std::min<size_t>(std::max<size_t>(budget_words / 64, 1 << 10), (size_t(1) << 20) / sizeof(Word));
+        buffer_words_ = budget_words - 2 * block_words_;
+        fan_in_ = std::min<size_t>(std::max<size_t>(budget_words / block_words_, 4) - 3, 512);
+
+        std::string pattern = options.dir + "/extbfs.XXXXXX";
+        std::vector<char> name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+        if (mkdtemp(name.data()) != nullptr) work_dir_ = name.data();
+        else error_ = "cannot create a work directory in " + options.dir + ": " + std::strerror(errno);
+    }
+
+    ~ExternalBfs() {
+        if (work_dir_.empty()) return;
+        for (int i = 0; i < next_file_; i++) {
+            std::remove((work_dir_ + "/layer" + std::to_string(i)).c_str());
+        }
+        rmdir(work_dir_.c_str());
+    }
+
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    long long nodesExpanded() const { return expanded_; }
+    const std::vector<int>& path() const { return path_; }
+
+    /**
+     * @brief Number of boards at each distance from the goal, up to @p max_depth (-1: all)
+     *
+     * @p report, if set, is called with (depth, count) as soon as a layer is done.
+     */
+    bool distribution(int max_depth, std::vector<uint64_t>& counts,
+                      const std::function<void(int, uint64_t)>& report = nullptr) {
+        counts.clear();
+        if (!ok()) return false;
+        std::vector<LayerFile> layers(1);
+        if (!writeLayer(std::vector<Word>(1, goalBoard<Word>(n_).cells), layers[0])) return false;
+        while (layers.back().count > 0) {
+            int depth = static_cast<int>(counts.size());
+            counts.push_back(layers.back().count);
+            if (report) report(depth, layers.back().count);
+            if (depth == max_depth) break;
+            LayerFile next;
+            bool met = false;
+            Word meet = 0;
+            const LayerFile* previous = layers.size() > 1 ? &layers[layers.size() - 2] : nullptr;
+            if (!expand(layers.back(), previous, nullptr, next, met, meet)) return false;
+            if (layers.size() > 1) {
+                std::remove(layers[0].path.c_str());
+                layers.erase(layers.begin());
+            }
+            layers.push_back(next);
+        }
+        removeLayers(layers);
+        return true;
+    }
+
+    /**
+     * @brief Optimal number of moves from @p start to the goal, or SOLUTION_LIMIT
+     *
+     * SOLUTION_LIMIT means past options.max_depth, or an I/O error (see error()).
+     */
+    int solve(const PackedBoard<Word>& start) {
+        expanded_ = 0;
+        path_.clear();
+        if (!ok()) return SOLUTION_LIMIT;
+        PackedBoard<Word> goal = goalBoard<Word>(n_);
+        if (start == goal) return 0;
+
+        std::vector<LayerFile> forward(1), backward(1);
+        if (!writeLayer(std::vector<Word>(1, start.cells), forward[0]) ||
+            !writeLayer(std::vector<Word>(1, goal.cells), backward[0])) {
+            return SOLUTION_LIMIT;
+        }
+        int result = SOLUTION_LIMIT;
+        while (true) {
+            int depth = static_cast<int>(forward.size() + backward.size()) - 1;   // after this expansion
+            if (options_.max_depth >= 0 && depth > options_.max_depth) break;
+            bool grow_forward = forward.back().count <= backward.back().count;
+            std::vector<LayerFile>& own = grow_forward ? forward : backward;
+            std::vector<LayerFile>& other = grow_forward ? backward : forward;
+
+            LayerFile next;
+            bool met = false;
+            Word meet = 0;
+            const LayerFile* previous = own.size() > 1 ? &own[own.size() - 2] : nullptr;
+            if (!expand(own.back(), previous, &other.back(), next, met, meet)) break;
+            own.push_back(next);
+            if (met) {
+                result = depth;
+                if (options_.keep_layers) rebuildPath(meet, forward, backward);
+                break;
+            }
+            if (next.count == 0) break;   // unsolvable: the start's component is exhausted
+            if (!options_.keep_layers && own.size() > 2) {
+                std::remove(own[own.size() - 3].path.c_str());
+            }
+        }
+        removeLayers(forward);
+        removeLayers(backward);
+        return result;
+    }
+};
+
+/**
+ * @brief Solver interface (see batch_runner.h) over ExternalBfs
+ */
+template <typename Word>
+class ExternalBfsSolver {
+private:
+    ExternalBfs<Word> search_;
+
+public:
+    ExternalBfsSolver(int n, const ExternalBfsOptions& options) : search_(n, options) {}
+
+    bool ok() const { return search_.ok(); }
+    const std::string& error() const { return search_.error(); }
+
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        int result = search_.solve(initial);
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start_time);
+        execution_time = duration.count() / 1000.0;
+        return result;
+    }
+
+    long long getNodesExpanded() const {
+        return search_.nodesExpanded();
+    }
+
+    // Empty unless the layers were kept (ExternalBfsOptions::keep_layers)
+    std::string getPath() const {
+        return pathToString(search_.path());
+    }
+};
+
+} // namespace puzzle
+
+#endif // EXTERNAL_BFS_H
@@ -0,0 +1,454 @@
+// hda_parallel_solver.cpp
+// Intra-puzzle parallel A* (Hash Distributed A*, HDA*) with Manhattan distance.
+//
+// Every state is owned by one thread, chosen from the hash of its packed board.
+// Each thread keeps its own open list, node arena and best-g table; a child
+// owned by another thread is sent to it through a lock-free inbox
+// (message_queue.h) in batches. Duplicates therefore always meet at the same
+// thread and need no locking.
+//
+// The first goal generated is not necessarily optimal, so it only sets an
+// incumbent (atomic minimum); states with f >= incumbent are pruned and the
+// search ends when no thread has work left and no batch is in flight:
+//   activeWork = busy threads + posted but unprocessed batches
+// A sender increments it before posting, the receiver decrements it after
+// processing, and a thread decrements it when it runs out of local work, so
+// it can only reach zero once the whole search is quiescent.
+//
+// Until the incumbent exists nothing bounds how deep a thread may go, so each
+// thread publishes the lowest f in its open list and does not expand beyond
+// the global minimum + F_SLACK (it flushes and yields instead). The thread
+// holding the minimum is never throttled, so this only limits speculation.
+//
+// Compile: g++ -std=c++17 -O3 -fopenmp -march=native -o hda_parallel hda_parallel_solver.cpp
+// Usage:   ./hda_parallel <puzzles_file> <num_threads> [--profile <phases.csv|.json>]
+//          (--profile needs -DPUZZLE_PROFILE, see instrumentation.h)
+
+#include <bits/stdc++.h>
+#include <omp.h>
+#include "puzzle_board.h"
+#include "state_table.h"
+#include "heuristics.h"
+#include "move_tables.h"
+#include "open_list.h"
+#include "message_queue.h"
+#include "instrumentation.h"
+using namespace std;
+
+typedef puzzle::PackedBoard<uint64_t> Board;
+
+struct Node {
+    Board board;
+    int g;
+    int h;
+};
+
+const int BATCH_SIZE = 64;
+typedef puzzle::MessageBatch<Node, BATCH_SIZE> Batch;
+
+struct PuzzleResult {
+    int puzzleIndex;
+    int solution;
+    long long nodesExpanded;
+    double executionTimeMs;
+    vector<long long> nodesPerThread;   // expansions done by each thread
+    long long messagesSent;             // states sent to another thread
+};
+
+class HDAStar {
+private:
+    static const long long MAX_NODES = 4000000;   // expansions over all threads
+    static const int FLUSH_INTERVAL = 32;         // expansions between outbox flushes
+    static const int INF = 1 << 30;
+    static const int F_SLACK = 2;                 // f grows in steps of 2 per layer
+
+    // One per thread, padded so the hot fields of two threads never share a line
+    struct alignas(64) Worker {
+        puzzle::BatchInbox<Batch> inbox;
+        atomic<int> minF;                      // lowest f queued here, INF if none
+        vector<Node> nodes;                    // arena, indices live in `open`
+        puzzle::BucketOpenList open;
+        puzzle::StateTable<uint64_t, int> bestG;
+        vector<Batch*> outbox;                 // pending batch per destination
+        long long expanded;
+        long long sent;
+
+        Worker() : minF(INF), bestG(1 << 16), expanded(0), sent(0) {}
+    };
+
+    int n;
+    int numThreads;
+    Board goal;
+    puzzle::ManhattanHeuristic<uint64_t> manhattan;
+    puzzle::MoveTable moves;
+    vector<unique_ptr<Worker>> workers;
+
+    atomic<int> incumbent;
+    atomic<long long> activeWork;
+    atomic<long long> totalExpanded;
+    atomic<bool> aborted;
+
+    int ownerOf(const Board& b) const {
+        // High bits: the per-thread tables index with the low bits of the same hash
+        return (int)((puzzle::hashWord(b.cells) >> 40) % (uint64_t)numThreads);
+    }
+
+    void offerIncumbent(int cost) {
+        int cur = incumbent.load();
+        while (cost < cur && !incumbent.compare_exchange_weak(cur, cost)) {}
+    }
+
+    // Owner side: keep the state if it improves on the best g seen so far
+    void receive(Worker& w, const Node& node) {
+        if (node.g + node.h >= incumbent.load(memory_order_relaxed)) return;
+        int* g = PUZZLE_TIMED(puzzle::PHASE_HASH_LOOKUP, w.bestG.find(node.board.cells));
+        if (g != nullptr) {
+            if (*g <= node.g) return;
+            *g = node.g;   // reopened through a cheaper path
+        } else {
+            PUZZLE_TIMED(puzzle::PHASE_HASH_INSERT, w.bestG.insert(node.board.cells, node.g));
+        }
+        PUZZLE_TIMED(puzzle::PHASE_OPEN_PUSH, w.open.push((uint32_t)w.nodes.size(), node.g + node.h, node.h));
+        PUZZLE_TIMED(puzzle::PHASE_ALLOC, w.nodes.push_back(node));
+    }
+
+    void flush(Worker& w, int dest) {
+        Batch* batch = w.outbox[dest];
+        if (batch == nullptr) return;
+        w.outbox[dest] = nullptr;
+        activeWork.fetch_add(1);   // before posting, so the count never dips to 0
+        workers[dest]->inbox.post(batch);
+    }
+
+    void flushAll(Worker& w) {
+        for (int d = 0; d < numThreads; ++d) flush(w, d);
+    }
+
+    void send(Worker& w, int dest, const Node& node) {
+        Batch*& batch = w.outbox[dest];
+        if (batch == nullptr) batch = new Batch();
+        batch->add(node);
+        w.sent++;
+        if (batch->full()) flush(w, dest);
+    }
+
+    // Returns true if at least one batch was processed
+    bool drainInbox(Worker& w) {
+        Batch* batch = w.inbox.takeAll();
+        if (batch == nullptr) return false;
+        while (batch != nullptr) {
+            Batch* next = batch->next;
+            for (int i = 0; i < batch->count; ++i) receive(w, batch->items[i]);
+            delete batch;
+            activeWork.fetch_sub(1);
+            batch = next;
+        }
+        return true;
+    }
+
+    void expand(int tid, Worker& w) {
+        Node cur = w.nodes[PUZZLE_TIMED(puzzle::PHASE_OPEN_POP, w.open.pop())];
+        int* best = PUZZLE_TIMED(puzzle::PHASE_HASH_LOOKUP, w.bestG.find(cur.board.cells));
+        if (best != nullptr && *best < cur.g) {
+            w.open.markStale();
+            return;
+        }
+        w.expanded++;
+        PUZZLE_SCOPE(puzzle::PHASE_EXPAND);
+
+        // Nodes carry no parent move (it would pad them to 32 bytes), so the
+        // child that undoes it is generated and dropped by its owner's bestG
+        const puzzle::BlankMoves& legal = moves.at(cur.board.blank);
+        for (int k = 0; k < legal.count; ++k) {
+            Node child;
+            child.board = cur.board;
+            int target = legal.target[k];
+            int tile = child.board.slide(target);
+            child.g = cur.g + 1;
+            child.h = PUZZLE_TIMED(puzzle::PHASE_HEURISTIC,
+                                   manhattan.update(cur.h, child.board, tile, target, cur.board.blank));
+
+            if (child.h == 0) {   // Manhattan is 0 only on the goal
+                offerIncumbent(child.g);
+                continue;
+            }
+            if (child.g + child.h >= incumbent.load(memory_order_relaxed)) continue;
+
+            int dest = ownerOf(child.board);
+            if (dest == tid) receive(w, child);
+            else send(w, dest, child);
+        }
+    }
+
+    // Lowest f this worker can still expand (INF if nothing beats the incumbent)
+    int publishLocalF(Worker& w) {
+        int f = w.open.empty() ? INF : w.open.minF();
+        if (f >= incumbent.load(memory_order_relaxed)) f = INF;
+        if (w.minF.load(memory_order_relaxed) != f) w.minF.store(f, memory_order_relaxed);
+        return f;
+    }
+
+    int globalMinF() const {
+        int f = INF;
+        for (auto& w : workers) f = min(f, w->minF.load(memory_order_relaxed));
+        return f;
+    }
+
+    void run(int tid) {
+        Worker& w = *workers[tid];
+        int sinceFlush = 0;
+        long long reported = 0;
+
+        while (true) {
+            drainInbox(w);
+            if (aborted.load(memory_order_relaxed)) break;
+
+            int localF = publishLocalF(w);
+            if (localF < INF) {
+                if (localF > globalMinF() + F_SLACK) {
+                    flushAll(w);
+                    sinceFlush = 0;
+                    this_thread::yield();
+                    continue;
+                }
+                expand(tid, w);
+                if (++sinceFlush >= FLUSH_INTERVAL) {
+                    sinceFlush = 0;
+                    flushAll(w);
+                    if (totalExpanded.fetch_add(w.expanded - reported) + (w.expanded - reported) > MAX_NODES)
+                        aborted.store(true);
+                    reported = w.expanded;
+                }
+                continue;
+            }
+
+            flushAll(w);
+            sinceFlush = 0;
+            if (!w.inbox.empty()) continue;
+            w.minF.store(INF, memory_order_relaxed);
+
+            // Out of work: leave the active count and wait for mail or quiescence
+            activeWork.fetch_sub(1);
+            bool woken = false;
+            while (!aborted.load(memory_order_relaxed)) {
+                if (!w.inbox.empty()) {
+                    activeWork.fetch_add(1);   // the pending batch keeps it above 0
+                    woken = true;
+                    break;
+                }
+                if (activeWork.load() == 0) break;
+                this_thread::yield();
+            }
+            if (!woken) break;
+        }
+        totalExpanded.fetch_add(w.expanded - reported);
+    }
+
+public:
+    HDAStar(int size, int threads)
+        : n(size), numThreads(threads), goal(puzzle::goalBoard<uint64_t>(size)), manhattan(size), moves(size) {
+        for (int t = 0; t < numThreads; ++t) {
+            workers.emplace_back(new Worker());
+            workers.back()->outbox.assign(numThreads, nullptr);
+        }
+    }
+
+    ~HDAStar() {
+        for (auto& w : workers) {
+            for (Batch*& b : w->outbox) { delete b; b = nullptr; }
+        }
+    }
+
+    // Returns the optimal number of moves, or -1 if the node limit was hit
+    int solve(const Board& start, PuzzleResult& result) {
+        result.nodesPerThread.assign(numThreads, 0);
+        result.nodesExpanded = 0;
+        result.messagesSent = 0;
+        if (start == goal) return 0;
+
+        for (auto& w : workers) {
+            w->nodes.clear();
+            w->open.clear();
+            w->bestG.clear();
+            w->expanded = 0;
+            w->sent = 0;
+            w->minF.store(INF);
+        }
+        incumbent.store(INF);
+        activeWork.store(numThreads);
+        totalExpanded.store(0);
+        aborted.store(false);
+
+        Node root;
+        root.board = start;
+        root.g = 0;
+        root.h = manhattan.initial(start);
+        receive(*workers[ownerOf(start)], root);
+
+        // Plain threads, not an OpenMP team: states are hashed to all numThreads
+        // owners, and OpenMP may start fewer threads than asked (OMP_THREAD_LIMIT)
+        vector<thread> team;
+        for (int t = 1; t < numThreads; ++t) team.emplace_back(&HDAStar::run, this, t);
+        run(0);
+        for (thread& th : team) th.join();
+
+        // After an abort batches may still be queued or half-filled
+        for (auto& w : workers) {
+            drainInbox(*w);
+            for (Batch*& b : w->outbox) { delete b; b = nullptr; }
+        }
+
+        for (int t = 0; t < numThreads; ++t) {
+            result.nodesPerThread[t] = workers[t]->expanded;
+            result.nodesExpanded += workers[t]->expanded;
+            result.messagesSent += workers[t]->sent;
+        }
+        if (aborted.load()) return -1;
+        int cost = incumbent.load();
+        return cost == INF ? -1 : cost;
+    }
+};
+
+// Solves every puzzle in order, each one with `numThreads` cooperating threads
+pair<vector<PuzzleResult>, double> processAll(const vector<pair<int,string>>& puzzles, int numThreads) {
+    vector<PuzzleResult> results;
+    results.reserve(puzzles.size());
+    map<int, unique_ptr<HDAStar>> solvers;   // one per board size, reused
+
+    double t0 = omp_get_wtime();
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        int n = puzzles[i].first;
+        PuzzleResult r;
+        r.puzzleIndex = (int)i;
+        r.solution = -1;
+        r.nodesExpanded = 0;
+        r.messagesSent = 0;
+        r.nodesPerThread.assign(numThreads, 0);
+
+        double s = omp_get_wtime();
+        Board start;
+        if (!puzzle::parseBoard(puzzles[i].second, n, start)) {
+            // invalid board: stays -1
+        } else if (!puzzle::isSolvable(start, n)) {
+            r.solution = puzzle::SOLUTION_UNSOLVABLE;
+        } else {
+            auto& solver = solvers[n];
+            if (!solver) solver.reset(new HDAStar(n, numThreads));
+            r.solution = solver->solve(start, r);
+        }
+        r.executionTimeMs = (omp_get_wtime() - s) * 1000.0;
+        results.push_back(r);
+    }
+    double total_ms = (omp_get_wtime() - t0) * 1000.0;
+    return {results, total_ms};
+}
+
+void printSummaryAndCSV(const vector<PuzzleResult>& seq, double seqWallMs,
+                        const vector<PuzzleResult>& par, double parWallMs,
+                        int numThreads, const string& csvName = "hda_results.csv")
+{
+    long long seqNodes = 0, parNodes = 0, parMessages = 0;
+    for (auto &r : seq) seqNodes += r.nodesExpanded;
+    for (auto &r : par) { parNodes += r.nodesExpanded; parMessages += r.messagesSent; }
+
+    int mismatches = 0;
+    for (size_t i = 0; i < seq.size() && i < par.size(); ++i)
+        if (seq[i].solution != par[i].solution) mismatches++;
+
+    double speedup = seqWallMs / parWallMs;
+    double efficiency = speedup / (double)numThreads;
+
+    cout << fixed << setprecision(3);
+    cout << "\n=== EXECUTION SUMMARY (HDA*) ===\n";
+    cout << "Puzzles: " << seq.size() << "\n";
+    cout << "Threads: " << numThreads << "\n";
+    cout << "Sequential wall time (ms): " << seqWallMs << "\n";
+    cout << "Parallel wall time (ms):   " << parWallMs << "\n";
+    cout << "Speedup (wall): " << speedup << "x\n";
+    cout << "Efficiency: " << (efficiency * 100.0) << " %\n";
+    cout << "Sequential total nodes: " << seqNodes << "\n";
+    cout << "Parallel total nodes:   " << parNodes << "\n";
+    cout << "Search overhead: " << (seqNodes > 0 ? (double)parNodes / seqNodes : 0.0) << "x\n";
+    cout << "States sent between threads: " << parMessages << "\n";
+    cout << "Solution mismatches vs sequential: " << mismatches << "\n";
+
+    vector<long long> nodesPerThread(numThreads, 0);
+    for (auto &r : par)
+        for (int t = 0; t < numThreads && t < (int)r.nodesPerThread.size(); ++t)
+            nodesPerThread[t] += r.nodesPerThread[t];
+
+    cout << "\n=== NODES PER THREAD ===\n";
+    for (int t = 0; t < numThreads; ++t) {
+        cout << "Thread " << t << ": nodes=" << nodesPerThread[t]
+             << ", share=" << (parNodes > 0 ? nodesPerThread[t] * 100.0 / parNodes : 0.0) << " %\n";
+    }
+
+    ofstream fout(csvName);
+    fout << "puzzle_index,solution,nodes_expanded,per_puzzle_ms,threads_used,messages_sent,max_thread_nodes\n";
+    for (auto &r : par) {
+        long long maxThread = 0;
+        for (long long v : r.nodesPerThread) maxThread = max(maxThread, v);
+        fout << r.puzzleIndex << "," << r.solution << "," << r.nodesExpanded << ","
+             << r.executionTimeMs << "," << numThreads << "," << r.messagesSent << ","
+             << maxThread << "\n";
+    }
+    fout.close();
+    cerr << "Wrote CSV: " << csvName << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    string profileFile;
+    if (argc == 5 && string(argv[3]) == "--profile") profileFile = argv[4];
+    if (argc < 3 || (argc > 3 && profileFile.empty())) {
+        cerr << "Usage: " << argv[0] << " <puzzles_file> <num_threads> [--profile <phases.csv|.json>]\n";
+        return 1;
+    }
+    if (!profileFile.empty() && !puzzle::PROFILE_ENABLED) {
+        cerr << "Error: --profile needs a build with -DPUZZLE_PROFILE\n";
+        return 1;
+    }
+    string filename = argv[1];
+    int numThreads = atoi(argv[2]);
+    if (numThreads <= 0) numThreads = 1;
+
+    // Read puzzles file (one board per line). Assumes 4x4 puzzles.
+    vector<pair<int,string>> puzzles;
+    ifstream fin(filename);
+    if (!fin) {
+        cerr << "Cannot open file: " << filename << "\n";
+        return 1;
+    }
+    string line;
+    while (getline(fin, line)) {
+        if (line.empty()) continue;
+        string s;
+        for (char c : line) if (!isspace((unsigned char)c)) s.push_back(c);
+        if (!s.empty()) puzzles.push_back({4, s});
+    }
+    fin.close();
+
+    if (puzzles.empty()) {
+        cerr << "No puzzles found in file.\n";
+        return 1;
+    }
+
+    cout << "Loaded " << puzzles.size() << " puzzles. Running HDA* with 1 and "
+         << numThreads << " threads.\n";
+
+    // Sequential baseline: same engine, one thread owns every state
+    auto seqPair = processAll(puzzles, 1);
+
+    // Parallel: every puzzle is searched by all threads together
+    auto parPair = processAll(puzzles, numThreads);
+
+    printSummaryAndCSV(seqPair.first, seqPair.second, parPair.first, parPair.second, numThreads);
+
+    if (!profileFile.empty()) {
+        if (!puzzle::writeProfile(profileFile)) {
+            cerr << "Cannot write file: " << profileFile << "\n";
+            return 1;
+        }
+        cerr << "Wrote profile: " << profileFile << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file heuristics.h
+ * @brief Table-driven heuristics with O(1) incremental updates
+ *
+ * Every heuristic here exposes the same interface, used as a template
+ * parameter by the search engines:
+ *
+ *   int initial(const PackedBoard<Word>& board) const;
+ *       Full evaluation, O(N^2). Used once per search for the start state.
+ *
+ *   int update(int parent_h, const PackedBoard<Word>& child,
+ *              int tile, int from, int to) const;
+ *       h of @p child, obtained from its parent by sliding @p tile from
+ *       position @p from to position @p to. A slide changes the contribution
+ *       of that single tile only, so table heuristics answer with two lookups.
+ */
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "puzzle_board.h"
+
+namespace puzzle {
+
+/**
+ * @brief Heuristic that sums a precomputed cost[tile][position] table
+ *
+ * Side > 0 fixes the board side at compile time (see BoardDim): the row
+ * stride of the table becomes a constant and initial() unrolls.
+ */
+template <typename Word, int Side = 0>
+class TileCostHeuristic {
+protected:
+    BoardDim<Side> N;
+    BoardDim<Side * Side> cells;
+    std::vector<uint8_t> cost_;   // cost_[tile * cells + pos], row 0 (blank) is all zero
+
+    explicit TileCostHeuristic(int n) : N(n), cells(n * n), cost_(n * n * n * n, 0) {}
+
+public:
+    int cost(int tile, int pos) const {
+        return cost_[tile * cells + pos];
+    }
+
+    int initial(const PackedBoard<Word>& board) const {
+        int h = 0;
+        for (int pos = 0; pos < cells; pos++) {
+            h += cost(board.tile(pos), pos);
+        }
+        return h;
+    }
+
+    int update(int parent_h, const PackedBoard<Word>&, int tile, int from, int to) const {
+        return parent_h - cost(tile, from) + cost(tile, to);
+    }
+};
+
+/**
+ * @brief h1: sum of Manhattan distances of every tile to its goal cell
+ */
+template <typename Word, int Side = 0>
+class ManhattanHeuristic : public TileCostHeuristic<Word, Side> {
+public:
+    explicit ManhattanHeuristic(int n) : TileCostHeuristic<Word, Side>(n) {
+        for (int tile = 1; tile < n * n; tile++) {
+            int target_row = (tile - 1) / n;
+            int target_col = (tile - 1) % n;
+            for (int pos = 0; pos < n * n; pos++) {
+                this->cost_[tile * n * n + pos] =
+                    static_cast<uint8_t>(abs(pos / n - target_row) + abs(pos % n - target_col));
+            }
+        }
+    }
+};
+
+/**
+ * @brief h2: number of tiles that are not on their goal cell
+ */
+template <typename Word, int Side = 0>
+class MisplacedTilesHeuristic : public TileCostHeuristic<Word, Side> {
+public:
+    explicit MisplacedTilesHeuristic(int n) : TileCostHeuristic<Word, Side>(n) {
+        for (int tile = 1; tile < n * n; tile++) {
+            for (int pos = 0; pos < n * n; pos++) {
+                this->cost_[tile * n * n + pos] = (pos != tile - 1) ? 1 : 0;
+            }
+        }
+    }
+};
+
+} // namespace puzzle
+
+#endif // HEURISTICS_H
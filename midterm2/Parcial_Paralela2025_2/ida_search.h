@@ -0,0 +1,199 @@
+/**
+ * @file ida_search.h
+ * @brief IDA* with Manhattan distance + linear conflicts (and optional PDB)
+ *
+ * The linear-conflict heuristic is optionally combined (max) with an additive
+ * pattern database. Memory is O(depth): one board is modified in place with
+ * make/unmake moves and the heuristic is updated incrementally for the single
+ * tile that slides. With Side > 0 (see BoardDim) the line-conflict scans run
+ * over a compile-time side and unroll.
+ */
+#ifndef IDA_SEARCH_H
+#define IDA_SEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "puzzle_board.h"
+#include "heuristics.h"
+#include "pattern_db.h"
+#include "move_tables.h"
+#include "node_arena.h"
+#include "instrumentation.h"
+
+namespace puzzle {
+
+template <typename Word, int Side = 0>
+class IDAStar_LC {
+private:
+    BoardDim<Side> N;
+    PackedBoard<Word> board;
+    long long total_nodes_expanded;
+    bool aborted;
+
+    MoveTable moves;
+    ManhattanHeuristic<Word, Side> manhattan;
+    const PdbHeuristic<Word>* pdb;   // nullptr when running without a pattern database
+    std::vector<int> goal_row, goal_col;   // indexed by tile value
+    std::vector<int> row_conflicts, col_conflicts;
+    std::vector<int> path;       // path[d] = move taken at depth d on the current branch
+    std::vector<int> solution;   // path[0, g) when the goal was reached
+
+    // Work limit to keep runaway searches bounded (IDA* itself needs no memory cap)
+    static const long long MAX_NODES = 2000000000LL;
+    static const int FOUND = -1;
+    static const int INF = 1 << 30;
+
+    // Extra moves forced by tiles that sit in their goal line but in reversed
+    // order: every tile outside the longest increasing subsequence (by goal
+    // index along the line) has to leave the line and come back, costing 2.
+    int lineConflicts(int line, bool is_row) const {
+        int goals[8];
+        int count = 0;
+        for (int k = 0; k < N; k++) {
+            int pos = is_row ? line * N + k : k * N + line;
+            int tile = board.tile(pos);
+            if (tile == 0) continue;
+            if (is_row && goal_row[tile] == line) goals[count++] = goal_col[tile];
+            if (!is_row && goal_col[tile] == line) goals[count++] = goal_row[tile];
+        }
+
+        int lis[8];
+        int longest = 0;
+        for (int i = 0; i < count; i++) {
+            lis[i] = 1;
+            for (int j = 0; j < i; j++) {
+                if (goals[j] < goals[i] && lis[j] + 1 > lis[i]) lis[i] = lis[j] + 1;
+            }
+            longest = std::max(longest, lis[i]);
+        }
+        return 2 * (count - longest);
+    }
+
+    int totalConflicts() {
+        int total = 0;
+        for (int line = 0; line < N; line++) {
+            row_conflicts[line] = lineConflicts(line, true);
+            col_conflicts[line] = lineConflicts(line, false);
+            total += row_conflicts[line] + col_conflicts[line];
+        }
+        return total;
+    }
+
+    // Returns FOUND, or the smallest f that exceeded `bound`
+    int search(int g, int md, int lc, int ph, int bound, int parent_move) {
+        int f = g + std::max(md + lc, ph);
+        if (f > bound) return f;
+        if (md == 0) {
+            solution.assign(path.begin(), path.begin() + g);
+            return FOUND;
+        }
+        if (++total_nodes_expanded >= MAX_NODES) {
+            aborted = true;
+            return INF;
+        }
+        PUZZLE_COUNT(PHASE_EXPAND);   // recursive, so only counted
+
+        int blank = board.blank;
+        int blank_row = blank / N;
+        int blank_col = blank % N;
+        const BlankMoves& legal = moves.at(blank);
+        int min_exceeded = INF;
+
+        for (int k = 0; k < legal.count; k++) {
+            int move = legal.move[k];
+            if (undoes(move, parent_move)) continue;   // never undo the previous move
+            int from = legal.target[k];
+            bool vertical = move == MOVE_UP || move == MOVE_DOWN;
+
+            // Make: the tile at `from` slides into the blank
+            int tile = board.slide(from);
+            int child_md = PUZZLE_TIMED(PHASE_HEURISTIC, manhattan.update(md, board, tile, from, blank));
+
+            // A vertical slide only changes the two rows involved, a horizontal
+            // slide only the two columns
+            std::vector<int>& lines = vertical ? row_conflicts : col_conflicts;
+            int a = vertical ? from / N : from % N;
+            int b = vertical ? blank_row : blank_col;
+            int old_a = lines[a];
+            int old_b = lines[b];
+            lines[a] = PUZZLE_TIMED(PHASE_HEURISTIC, lineConflicts(a, vertical));
+            lines[b] = PUZZLE_TIMED(PHASE_HEURISTIC, lineConflicts(b, vertical));
+            int child_lc = lc - old_a - old_b + lines[a] + lines[b];
+            int child_ph = pdb ? PUZZLE_TIMED(PHASE_HEURISTIC, pdb->update(ph, board, tile, from, blank)) : 0;
+
+            path[g] = move;
+            int t = search(g + 1, child_md, child_lc, child_ph, bound, move);
+
+            // Unmake
+            lines[a] = old_a;
+            lines[b] = old_b;
+            board.slide(blank);
+
+            if (t == FOUND) return FOUND;
+            if (aborted) return INF;
+            if (t < min_exceeded) min_exceeded = t;
+        }
+        return min_exceeded;
+    }
+
+public:
+    IDAStar_LC(int size, const PdbHeuristic<Word>* pattern_heuristic)
+        : N(size), total_nodes_expanded(0), aborted(false), moves(size), manhattan(size), pdb(pattern_heuristic),
+          goal_row(size * size), goal_col(size * size),
+          row_conflicts(size), col_conflicts(size) {
+        for (int tile = 1; tile < N * N; tile++) {
+            goal_row[tile] = (tile - 1) / N;
+            goal_col[tile] = (tile - 1) % N;
+        }
+    }
+
+    int solve(const PackedBoard<Word>& initial, double& execution_time) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        board = initial;
+        total_nodes_expanded = 0;
+        aborted = false;
+        solution.clear();
+        int solution_length = SOLUTION_UNSOLVABLE;
+
+        if (isSolvable(board, N)) {
+            solution_length = SOLUTION_LIMIT;
+            int md = manhattan.initial(board);
+            int lc = totalConflicts();
+            int ph = pdb ? pdb->initial(board) : 0;
+            int bound = std::max(md + lc, ph);
+
+            while (true) {
+                path.resize(bound + 1);   // a branch never gets deeper than the bound
+                int t = search(0, md, lc, ph, bound, MOVE_NONE);
+                if (t == FOUND) {
+                    solution_length = bound;
+                    break;
+                }
+                if (aborted || t == INF) break;
+                bound = t;
+            }
+        }
+
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        execution_time = duration.count() / 1000.0; // Convert to milliseconds
+        return solution_length;
+    }
+
+    long long getNodesExpanded() const {
+        return total_nodes_expanded;
+    }
+
+    // Moves of the blank for the last solved puzzle; the DFS stack is the path
+    std::string getPath() const {
+        return pathToString(solution);
+    }
+};
+
+} // namespace puzzle
+
+#endif // IDA_SEARCH_H
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstdlib>
+
+#include "solver_algorithms.h"
+#include "batch_runner.h"
+
+template <typename Word, typename Algorithm>
+bool solveWith(std::ifstream& file, const puzzle::SolverConfig& config, const char* label, bool paths,
+               const puzzle::BatchFormat& format) {
+    std::unique_ptr<typename Algorithm::Solver> solver(Algorithm::create(config));
+    return puzzle::solveBatch<Word>(file, config.n, *solver, label, paths, format, puzzle::NoPuzzleHook());
+}
+
+// Instantiated per board size by puzzle::dispatchBoardSize
+template <typename Word, int Side>
+struct SolveIDA {
+    static bool run(std::ifstream& file, const puzzle::SolverConfig& config, bool paths,
+                    const puzzle::BatchFormat& format) {
+        if (config.pdb != nullptr) {
+            return solveWith<Word, puzzle::IdaPdbAlgorithm<Word, Side> >(file, config, "IDA*-pdb", paths, format);
+        }
+        return solveWith<Word, puzzle::IdaAlgorithm<Word, Side> >(file, config, "IDA*-lc", paths, format);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    // Rows leave in large buffered writes instead of one flush per puzzle
+    std::ios::sync_with_stdio(false);
+    std::string pdb_file;
+    bool paths = false;
+    puzzle::BatchFormat format;
+    bool bad_args = argc < 3;
+    for (int i = 3; i < argc && !bad_args; i++) {
+        std::string arg = argv[i];
+        if (arg == "--paths") paths = true;
+        else if (arg == "--pdb" && i + 1 < argc) pdb_file = argv[++i];
+        else if (arg == "--bin-in") format.binary_input = true;
+        else if (arg == "--bin-out" && i + 1 < argc) format.results_file = argv[++i];
+        else bad_args = true;
+    }
+    if (bad_args || (paths && !format.results_file.empty())) {
+        std::cerr << "Usage: " << argv[0] << " <puzzles_file> <N_size> [--pdb <file.pdb>] [--paths]"
+                  << " [--bin-in] [--bin-out <results.spr>]" << std::endl;
+        return 1;
+    }
+
+    std::string filename = argv[1];
+    int N = std::atoi(argv[2]);
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return 1;
+    }
+
+    puzzle::PatternDatabase pdb;
+    if (!pdb_file.empty()) {
+        std::string error;
+        if (!pdb.load(pdb_file, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        if (pdb.boardSize() != N) {
+            std::cerr << "Error: " << pdb_file << " was built for N=" << pdb.boardSize() << std::endl;
+            return 1;
+        }
+    }
+    puzzle::SolverConfig config;
+    config.n = N;
+    config.pdb = pdb_file.empty() ? nullptr : &pdb;
+
+    bool ok = false;
+    if (puzzle::supportedBoardSize(N)) {
+        ok = puzzle::dispatchBoardSize<SolveIDA>(N, file, config, paths, format);
+    } else {
+        std::cerr << "Error: Unsupported board size " << N << " (supported: 2..5)" << std::endl;
+        return 1;
+    }
+
+    file.close();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file instrumentation.h
+ * @brief Per-thread phase counters and timers for the search hot paths
+ *
+ * Solvers mark their hot operations with PUZZLE_TIMED(phase, expression),
+ * PUZZLE_SCOPE(phase) (rest of the enclosing block) or PUZZLE_COUNT(phase)
+ * (calls only). Without -DPUZZLE_PROFILE the macros reduce to the bare
+ * expression or to nothing, so the normal builds are unchanged. With it, each
+ * marked call bumps a call counter owned by the calling thread (no atomics or
+ * locks on the hot path), and one call in PUZZLE_PROFILE_SAMPLE (default 16)
+ * is also timed. Reading the clock costs about as much as a hash probe, so
+ * timing every call would mostly measure the timer; the reported total is
+ * the sampled average times the exact call count. Build with
+ * -DPUZZLE_PROFILE_SAMPLE=1 to time every call.
+ *
+ * Ticks come from RDTSC on x86 and from steady_clock elsewhere; writeProfile
+ * subtracts the cost of two back-to-back clock reads from every sampled call
+ * and converts ticks to nanoseconds with a rate measured from the first
+ * profiled call to the write.
+ * Phases nest (an A* expansion includes its heuristic updates), so each
+ * phase's time is inclusive.
+ *
+ * Per-thread records are kept by a process-wide registry until exit, so the
+ * profile can be written after the worker threads are gone.
+ */
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace puzzle {
+
+enum ProfilePhase {
+    PHASE_EXPAND,        // generating the children of one node
+    PHASE_HEURISTIC,     // heuristic evaluation or incremental update
+    PHASE_HASH_LOOKUP,   // visited/closed table membership tests
+    PHASE_HASH_INSERT,   // visited/closed table inserts
+    PHASE_OPEN_PUSH,
+    PHASE_OPEN_POP,
+    PHASE_ALLOC,         // node arena / queue appends
+    PHASE_COUNT
+};
+
+inline const char* phaseName(int phase) {
+    static const char* names[] = {"expand", "heuristic", "hash_lookup", "hash_insert",
+                                  "open_push", "open_pop", "alloc"};
+    return names[phase];
+}
+
+#ifdef PUZZLE_PROFILE
+static const bool PROFILE_ENABLED = true;
+#else
+static const bool PROFILE_ENABLED = false;
+#endif
+
+#ifndef PUZZLE_PROFILE_SAMPLE
+#define PUZZLE_PROFILE_SAMPLE 16
+#endif
+static const uint64_t PROFILE_SAMPLE = PUZZLE_PROFILE_SAMPLE;   // power of two
+static_assert((PROFILE_SAMPLE & (PROFILE_SAMPLE - 1)) == 0, "PUZZLE_PROFILE_SAMPLE must be a power of two");
+
+inline uint64_t profileTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline const char* profileClockName() {
+#if defined(__x86_64__) || defined(__i386__)
+    return "rdtsc";
+#else
+    return "steady_clock";
+#endif
+}
+
+/**
+ * @brief Counters of one thread; only that thread writes them
+ */
+struct ThreadProfile {
+    int thread;   // registration order
+    uint64_t calls[PHASE_COUNT];
+    uint64_t timed[PHASE_COUNT];   // sampled calls
+    uint64_t ticks[PHASE_COUNT];   // spent in the sampled calls
+
+    explicit ThreadProfile(int id) : thread(id) {
+        for (int p = 0; p < PHASE_COUNT; p++) calls[p] = timed[p] = ticks[p] = 0;
+    }
+};
+
+class ProfileRegistry {
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadProfile> > threads_;
+    uint64_t start_ticks_;
+    std::chrono::steady_clock::time_point start_time_;
+    uint64_t overhead_ticks_;   // smallest difference of two consecutive reads
+
+    ProfileRegistry() : start_ticks_(profileTicks()), start_time_(std::chrono::steady_clock::now()) {
+        overhead_ticks_ = ~0ULL;
+        for (int i = 0; i < 1000; i++) {
+            uint64_t t0 = profileTicks();
+            uint64_t t1 = profileTicks();
+            if (t1 - t0 < overhead_ticks_) overhead_ticks_ = t1 - t0;
+        }
+    }
+
+    // Nanoseconds per tick, measured from construction to now
+    double nsPerTick() {
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time_).count());
+        uint64_t ticks = profileTicks() - start_ticks_;
+        return ticks > 0 ? ns / static_cast<double>(ticks) : 1.0;
+    }
+
+public:
+    static ProfileRegistry& instance() {
+        static ProfileRegistry registry;
+        return registry;
+    }
+
+    ThreadProfile* add() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.emplace_back(new ThreadProfile(static_cast<int>(threads_.size())));
+        return threads_.back().get();
+    }
+
+    /**
+     * @brief Writes the counters of every thread and their total to @p path
+     *
+     * JSON when the name ends in ".json", CSV (thread,phase,calls,timed_calls,
+     * total_ns,avg_ns; thread "all" for the totals) otherwise. Call once the workers
+     * have finished. Returns false if the file cannot be written.
+     */
+    bool write(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FILE* out = std::fopen(path.c_str(), "w");
+        if (out == nullptr) return false;
+        double scale = nsPerTick();
+        bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+        ThreadProfile total(-1);
+        for (size_t t = 0; t < threads_.size(); t++) {
+            for (int p = 0; p < PHASE_COUNT; p++) {
+                total.calls[p] += threads_[t]->calls[p];
+                total.timed[p] += threads_[t]->timed[p];
+                total.ticks[p] += threads_[t]->ticks[p];
+            }
+        }
+
+        if (json) {
+            std::fprintf(out, "{\"clock\": \"%s\", \"threads\": [", profileClockName());
+            for (size_t t = 0; t < threads_.size(); t++) {
+                std::fprintf(out, "%s\n  {\"thread\": %d, \"phases\": ", t ? "," : "", threads_[t]->thread);
+                writeJsonPhases(out, *threads_[t], scale);
+                std::fprintf(out, "}");
+            }
+            std::fprintf(out, "\n], \"total\": ");
+            writeJsonPhases(out, total, scale);
+            std::fprintf(out, "}\n");
+        } else {
+            std::fprintf(out, "thread,phase,calls,timed_calls,total_ns,avg_ns\n");
+            for (size_t t = 0; t < threads_.size(); t++) writeCsvRows(out, *threads_[t], scale);
+            writeCsvRows(out, total, scale);
+        }
+        return std::fclose(out) == 0;
+    }
+
+private:
+    // Average over the sampled calls without the clock reads, in ns
+    double averageNs(const ThreadProfile& row, int p, double scale) const {
+        if (row.timed[p] == 0) return 0.0;
+        double ticks = static_cast<double>(row.ticks[p]) / static_cast<double>(row.timed[p]);
+        ticks -= static_cast<double>(overhead_ticks_);
+        return ticks > 0.0 ? ticks * scale : 0.0;
+    }
+
+    void writeJsonPhases(FILE* out, const ThreadProfile& row, double scale) const {
+        std::fprintf(out, "{");
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            double avg = averageNs(row, p, scale);
+            std::fprintf(out, "%s\"%s\": {\"calls\": %llu, \"timed_calls\": %llu, \"total_ns\": %.0f, \"avg_ns\": %.2f}",
+                         p ? ", " : "", phaseName(p), static_cast<unsigned long long>(row.calls[p]),
+                         static_cast<unsigned long long>(row.timed[p]), avg * static_cast<double>(row.calls[p]), avg);
+        }
+        std::fprintf(out, "}");
+    }
+
+    void writeCsvRows(FILE* out, const ThreadProfile& row, double scale) const {
+        std::string thread = row.thread < 0 ? "all" : std::to_string(row.thread);
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            double avg = averageNs(row, p, scale);
+            std::fprintf(out, "%s,%s,%llu,%llu,%.0f,%.2f\n", thread.c_str(), phaseName(p),
+                         static_cast<unsigned long long>(row.calls[p]), static_cast<unsigned long long>(row.timed[p]),
+                         avg * static_cast<double>(row.calls[p]), avg);
+        }
+    }
+};
+
+// The pointer is constant-initialized, so the hot path reads it without the
+// guard a dynamically initialized thread_local would check on every access
+inline ThreadProfile& threadProfile() {
+    static thread_local ThreadProfile* profile = nullptr;
+    if (__builtin_expect(profile == nullptr, 0)) profile = ProfileRegistry::instance().add();
+    return *profile;
+}
+
+inline bool writeProfile(const std::string& path) {
+    return ProfileRegistry::instance().write(path);
+}
+
+/**
+ * @brief Counts one call of a phase and, for sampled calls, times the object's lifetime
+ */
+class ScopedPhase {
+private:
+    ThreadProfile& profile_;
+    int phase_;
+    uint64_t start_;   // 0 when this call is not sampled
+
+public:
+    explicit ScopedPhase(int phase) : profile_(threadProfile()), phase_(phase), start_(0) {
+        if ((profile_.calls[phase]++ & (PROFILE_SAMPLE - 1)) == 0) start_ = profileTicks();
+    }
+    ~ScopedPhase() {
+        if (start_ == 0) return;
+        profile_.ticks[phase_] += profileTicks() - start_;
+        profile_.timed[phase_]++;
+    }
+};
+
+template <typename F>
+auto profileTimed(int phase, F f) -> decltype(f()) {
+    ScopedPhase scope(phase);
+    return f();
+}
+
+} // namespace puzzle
+
+#define PUZZLE_PROFILE_CONCAT2(a, b) a##b
+#define PUZZLE_PROFILE_CONCAT(a, b) PUZZLE_PROFILE_CONCAT2(a, b)
+
+#ifdef PUZZLE_PROFILE
+#define PUZZLE_TIMED(phase, ...) (::puzzle::profileTimed((phase), [&]() { return (__VA_ARGS__); }))
+#define PUZZLE_SCOPE(phase) ::puzzle::ScopedPhase PUZZLE_PROFILE_CONCAT(profile_scope_, __LINE__)(phase)
+#define PUZZLE_COUNT(phase) (++::puzzle::threadProfile().calls[(phase)])
+#else
+#define PUZZLE_TIMED(phase, ...) (__VA_ARGS__)
+#define PUZZLE_SCOPE(phase) ((void)0)
+#define PUZZLE_COUNT(phase) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,163 @@
+/**
+ * @file level_bfs.h
+ * @brief Level-synchronous parallel BFS over packed boards (N <= 4)
+ *
+ * Breadth-first search visits states layer by layer, and every state of a
+ * layer can be expanded independently. LevelBFS expands each layer with an
+ * OpenMP loop: threads append the children they are first to claim in the
+ * shared ConcurrentStateSet to their own next-layer buffer, and the buffers
+ * are concatenated once the layer is done. No lock is taken and no thread
+ * waits for another inside a layer.
+ *
+ * All visited boards are kept in one vector, layer after layer, which doubles
+ * as the list of keys that clear() needs to empty the visited set.
+ *
+ * The goal is recognised when it is generated, so the answer is the same
+ * optimal depth as a queue-based BFS; node counts differ slightly because
+ * the last layer is not scanned in queue order. Compiled without OpenMP the
+ * engine runs the same loop on one thread.
+ */
+#ifndef LEVEL_BFS_H
+#define LEVEL_BFS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "puzzle_board.h"
+#include "state_table.h"
+#include "move_tables.h"
+#include "instrumentation.h"
+
+namespace puzzle {
+
+class LevelBFS {
+public:
+    typedef PackedBoard<uint64_t> Board;
+
+private:
+    MoveTable moves_;
+    int threads_;
+    size_t max_states_;
+    size_t max_layer_;
+    ConcurrentStateSet visited_;
+    std::vector<Board> states_;                // every visited board, by layer
+    std::vector<std::vector<Board> > next_;    // per-thread share of the next layer
+    std::vector<long long> expanded_;          // per-thread expansions
+    size_t peak_layer_;
+
+    static int threadId() {
+#ifdef _OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+    }
+
+public:
+    /**
+     * @param max_states stop (returning -1) once this many boards were visited
+     * @param max_layer  stop once a layer is larger than this (0 = no limit)
+     */
+    LevelBFS(int n, int threads, size_t max_states, size_t max_layer = 0)
+        : moves_(n), threads_(threads), max_states_(max_states), max_layer_(max_layer),
+          visited_(max_states), peak_layer_(0) {
+#ifndef _OPENMP
+        threads_ = 1;
+#endif
+        if (threads_ < 1) threads_ = 1;
+        next_.resize(threads_);
+        expanded_.assign(threads_, 0);
+    }
+
+    /**
+     * @brief Optimal number of moves from @p start to @p goal, or -1 past the limits
+     */
+    int solve(const Board& start, const Board& goal) {
+        const std::vector<Board>& old_states = states_;
+        visited_.clear(old_states.size(), [&old_states](size_t i) { return old_states[i].cells; });
+        states_.clear();
+        expanded_.assign(threads_, 0);
+        peak_layer_ = 0;
+
+        visited_.insert(start.cells);
+        states_.push_back(start);
+        if (start == goal) return 0;
+
+        size_t begin = 0, end = 1;
+
+        for (int depth = 0; begin < end; depth++) {
+            size_t layer = end - begin;
+            peak_layer_ = std::max(peak_layer_, layer);
+            if (states_.size() >= max_states_ || (max_layer_ != 0 && layer > max_layer_)) return -1;
+
+            // Each board has at most 4 children: the set must not fill up mid-layer
+            visited_.reserve(states_.size() + 4 * layer);
+            std::atomic<bool> found(false);
+
+            #pragma omp parallel num_threads(threads_)
+            {
+                int tid = threadId();
+                std::vector<Board>& out = next_[tid];
+                out.clear();
+                long long expanded = 0;
+
+                #pragma omp for schedule(dynamic, 1024)
+                for (long long i = (long long)begin; i < (long long)end; i++) {
+                    if (found.load(std::memory_order_relaxed)) continue;
+                    PUZZLE_SCOPE(PHASE_EXPAND);
+                    const Board& cur = states_[i];
+                    expanded++;
+                    const BlankMoves& legal = moves_.at(cur.blank);
+                    for (int k = 0; k < legal.count; k++) {
+                        Board nb = cur;
+                        nb.slide(legal.target[k]);
+                        if (nb == goal) {
+                            found.store(true, std::memory_order_relaxed);
+                            break;
+                        }
+                        if (PUZZLE_TIMED(PHASE_HASH_INSERT, visited_.insert(nb.cells))) {
+                            PUZZLE_TIMED(PHASE_ALLOC, out.push_back(nb));
+                        }
+                    }
+                }
+                expanded_[tid] += expanded;
+            }
+
+            // Appended even when the goal was found: clear() needs every key
+            size_t added = 0;
+            for (int t = 0; t < threads_; t++) added += next_[t].size();
+            states_.reserve(states_.size() + added);
+            for (int t = 0; t < threads_; t++) {
+                states_.insert(states_.end(), next_[t].begin(), next_[t].end());
+            }
+            if (found.load()) return depth + 1;
+
+            begin = end;
+            end = states_.size();
+        }
+        return -1;
+    }
+
+    long long nodesExpanded() const {
+        long long total = 0;
+        for (size_t t = 0; t < expanded_.size(); t++) total += expanded_[t];
+        return total;
+    }
+
+    const std::vector<long long>& nodesPerThread() const { return expanded_; }
+    size_t statesVisited() const { return states_.size(); }
+    size_t peakLayer() const { return peak_layer_; }
+    size_t tableCapacity() const { return visited_.capacity(); }
+    int threads() const { return threads_; }
+};
+
+} // namespace puzzle
+
+#endif // LEVEL_BFS_H
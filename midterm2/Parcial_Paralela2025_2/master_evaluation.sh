@@ -100,6 +100,18 @@ else
 fi
 echo ""
 
+# Tarea 13: Pattern databases
+echo "🧩 EJECUTANDO TAREA 13: Análisis de Pattern Databases"
+echo "====================================================="
+if [ -f "task_13_pdb_analysis.sh" ]; then
+    chmod +x task_13_pdb_analysis.sh
+    ./task_13_pdb_analysis.sh
+    echo "✅ Tarea 13 completada"
+else
+    echo "❌ Script task_13_pdb_analysis.sh no encontrado"
+fi
+echo ""
+
 # ============================================================================
 # GENERACIÓN DEL INFORME FINAL
 # ============================================================================
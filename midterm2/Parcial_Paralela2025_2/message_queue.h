@@ -0,0 +1,76 @@
+/**
+ * @file message_queue.h
+ * @brief Lock-free multi-producer / single-consumer inbox of message batches
+ *
+ * Used by the hash-distributed parallel searches: every thread owns one inbox,
+ * any thread may post to it, and only the owner drains it. Messages travel in
+ * fixed-size batches so the atomic traffic is paid once per batch instead of
+ * once per state.
+ *
+ * The inbox is a Treiber stack: post() links a batch in front of the head
+ * with a CAS loop, and takeAll() detaches the whole list with a single
+ * exchange. Because the consumer never pops individual nodes, there is no ABA
+ * problem and no memory reclamation scheme is needed: once detached, the
+ * batches belong to the consumer, which deletes them after processing.
+ * Batches come out newest first; callers that care about order must not
+ * depend on it.
+ */
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace puzzle {
+
+template <typename Entry, int Capacity>
+struct MessageBatch {
+    MessageBatch* next;
+    int count;
+    Entry items[Capacity];
+
+    MessageBatch() : next(nullptr), count(0) {}
+
+    bool full() const { return count == Capacity; }
+    void add(const Entry& e) { items[count++] = e; }
+};
+
+template <typename Batch>
+class BatchInbox {
+private:
+    std::atomic<Batch*> head_;
+
+    BatchInbox(const BatchInbox&);
+    BatchInbox& operator=(const BatchInbox&);
+
+public:
+    BatchInbox() : head_(nullptr) {}
+
+    /**
+     * @brief Publishes @p batch to the owner; ownership passes to the inbox
+     */
+    void post(Batch* batch) {
+        Batch* old_head = head_.load(std::memory_order_relaxed);
+        do {
+            batch->next = old_head;
+        } while (!head_.compare_exchange_weak(old_head, batch,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Detaches every posted batch (linked through Batch::next), or nullptr
+     */
+    Batch* takeAll() {
+        if (head_.load(std::memory_order_relaxed) == nullptr) return nullptr;
+        return head_.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+} // namespace puzzle
+
+#endif // MESSAGE_QUEUE_H
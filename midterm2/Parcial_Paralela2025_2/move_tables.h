@@ -0,0 +1,109 @@
+/**
+ * @file move_tables.h
+ * @brief Blank moves and the precomputed legal moves of every blank position
+ *
+ * Moves describe where the blank goes, in the UP/DOWN/LEFT/RIGHT vocabulary
+ * of board_moves.cpp. MoveTable lists, for each cell the blank can occupy,
+ * the legal moves in that order together with the cell the blank moves to,
+ * and a bitmask of them. Expanding a node walks 2 to 4 precomputed entries
+ * instead of testing four directions against the board edges.
+ *
+ * A move followed by its opposite returns to the grandparent, which a search
+ * has always seen already. Searches that remember the move that produced a
+ * node pass it to undoes() and skip that child.
+ */
+#ifndef MOVE_TABLES_H
+#define MOVE_TABLES_H
+
+#include <cstdint>
+#include <vector>
+
+namespace puzzle {
+
+enum Move {
+    MOVE_UP = 0,
+    MOVE_DOWN = 1,
+    MOVE_LEFT = 2,
+    MOVE_RIGHT = 3,
+    MOVE_NONE = 4     // root node
+};
+
+inline const char* moveName(int move) {
+    static const char* names[] = {"UP", "DOWN", "LEFT", "RIGHT", ""};
+    return names[move];
+}
+
+/**
+ * @brief Move that undoes @p move (UP <-> DOWN, LEFT <-> RIGHT)
+ */
+inline int oppositeMove(int move) {
+    return move ^ 1;
+}
+
+/**
+ * @brief @p move (UP..RIGHT) as seen on the mirrorBoard: UP <-> LEFT, DOWN <-> RIGHT
+ */
+inline int mirrorMove(int move) {
+    return move ^ 2;
+}
+
+/**
+ * @brief True if @p move goes back to where the blank was before @p parent_move
+ *
+ * MOVE_NONE (the root) has no opposite, so nothing is skipped after it.
+ */
+inline bool undoes(int move, int parent_move) {
+    return move == (parent_move ^ 1);
+}
+
+/**
+ * @brief Legal moves of the blank from one position
+ */
+struct BlankMoves {
+    int count;       // 2 (corner), 3 (edge) or 4
+    int mask;        // bit m set when move m is legal
+    int move[4];     // legal moves in UP, DOWN, LEFT, RIGHT order
+    int target[4];   // cell the blank moves to with move[k]
+};
+
+class MoveTable {
+private:
+    int n_;
+    std::vector<BlankMoves> table_;   // indexed by blank position
+
+public:
+    explicit MoveTable(int n) : n_(n), table_(n * n) {
+        const int dr[] = {-1, 1, 0, 0};
+        const int dc[] = {0, 0, -1, 1};
+        for (int pos = 0; pos < n * n; pos++) {
+            BlankMoves& entry = table_[pos];
+            entry.count = 0;
+            entry.mask = 0;
+            for (int m = 0; m < 4; m++) {
+                int row = pos / n + dr[m];
+                int col = pos % n + dc[m];
+                if (row < 0 || row >= n || col < 0 || col >= n) continue;
+                entry.move[entry.count] = m;
+                entry.target[entry.count] = row * n + col;
+                entry.count++;
+                entry.mask |= 1 << m;
+            }
+        }
+    }
+
+    int side() const { return n_; }
+
+    const BlankMoves& at(int blank) const { return table_[blank]; }
+};
+
+/**
+ * @brief Shared table for the packed board sizes, 2 <= n <= 5, built on first use
+ */
+inline const MoveTable& moveTableFor(int n) {
+    static const MoveTable tables[] = {MoveTable(2), MoveTable(3), MoveTable(4), MoveTable(5)};
+    return tables[n - 2];
+}
+
+} // namespace puzzle
+
+#endif // MOVE_TABLES_H
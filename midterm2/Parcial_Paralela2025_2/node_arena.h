@@ -0,0 +1,98 @@
+/**
+ * @file node_arena.h
+ * @brief Bump-allocated search nodes with parent links, and solution paths
+ *
+ * NodeArena hands out nodes from fixed-size blocks: allocating is bumping a
+ * counter, reset() rewinds it and keeps every block, so a solver that owns one
+ * arena for the whole batch stops touching malloc after the first large
+ * puzzle. Blocks never move, so node indices and references stay valid until
+ * the next reset(). Indices are 32-bit, half the size of a pointer.
+ *
+ * Nodes store the index of their parent and the move that produced them,
+ * which is enough to rebuild the move sequence from the root (pathTo). Moves
+ * are the blank moves of move_tables.h.
+ */
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "move_tables.h"
+
+namespace puzzle {
+
+static const uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+/**
+ * @brief Space-separated move names, e.g. "UP LEFT LEFT"
+ */
+inline std::string pathToString(const std::vector<int>& moves) {
+    std::string path;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (i > 0) path += ' ';
+        path += moveName(moves[i]);
+    }
+    return path;
+}
+
+template <typename Node>
+class NodeArena {
+private:
+    static const int BLOCK_BITS = 16;
+    static const size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+
+    std::vector<std::unique_ptr<Node[]> > blocks_;
+    size_t size_;
+
+    NodeArena(const NodeArena&);
+    NodeArena& operator=(const NodeArena&);
+
+public:
+    NodeArena() : size_(0) {}
+
+    /**
+     * @brief Appends a copy of @p node and returns its index
+     */
+    uint32_t push(const Node& node) {
+        if (size_ == blocks_.size() * BLOCK_SIZE) blocks_.emplace_back(new Node[BLOCK_SIZE]);
+        uint32_t index = static_cast<uint32_t>(size_++);
+        (*this)[index] = node;
+        return index;
+    }
+
+    Node& operator[](uint32_t index) {
+        return blocks_[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+    }
+
+    const Node& operator[](uint32_t index) const {
+        return blocks_[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return blocks_.size() * BLOCK_SIZE; }
+
+    /**
+     * @brief Forgets every node; the blocks are kept for the next search
+     */
+    void reset() { size_ = 0; }
+
+    /**
+     * @brief Moves from the root to node @p index (Node needs `parent` and `move`)
+     */
+    std::vector<int> pathTo(uint32_t index) const {
+        std::vector<int> moves;
+        while (index != NO_PARENT && (*this)[index].parent != NO_PARENT) {
+            moves.push_back((*this)[index].move);
+            index = (*this)[index].parent;
+        }
+        return std::vector<int>(moves.rbegin(), moves.rend());
+    }
+};
+
+} // namespace puzzle
+
+#endif // NODE_ARENA_H
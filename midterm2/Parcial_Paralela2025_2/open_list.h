@@ -0,0 +1,111 @@
+/**
+ * @file open_list.h
+ * @brief Bucketed A* open list over node indices
+ *
+ * f and h are small bounded integers, so instead of a binary heap of whole
+ * states the open list keeps one LIFO stack of node indices per (f, h) pair.
+ * pop() returns a node with the smallest f, breaking ties towards the smallest
+ * h (deepest node) and then towards the most recently pushed one. Both push()
+ * and pop() are O(1) amortized; the scan for the next non-empty bucket only
+ * moves forward while f is non-decreasing, which holds for consistent
+ * heuristics.
+ *
+ * Nodes themselves live in the caller's arena (e.g. a std::vector reused across
+ * puzzles); the open list only ever moves 32-bit indices. Duplicates are not
+ * removed on push: the caller detects them on pop (lazy deletion) and reports
+ * them with markStale().
+ */
+#ifndef OPEN_LIST_H
+#define OPEN_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace puzzle {
+
+struct OpenListStats {
+    size_t pushes;
+    size_t pops;
+    size_t stale;   // pops discarded by the caller (lazy deletion)
+    size_t peak;    // largest number of queued indices
+
+    double staleRatio() const { return pops ? (double)stale / pops : 0.0; }
+};
+
+class BucketOpenList {
+private:
+    // buckets_[f][h] is a stack of node indices
+    std::vector<std::vector<std::vector<uint32_t> > > buckets_;
+    std::vector<size_t> f_count_;   // entries queued per f
+    int min_f_;
+    size_t size_;
+    OpenListStats stats_;
+
+public:
+    BucketOpenList() : min_f_(0), size_(0) {
+        clear();
+    }
+
+    void push(uint32_t node, int f, int h) {
+        if (f >= static_cast<int>(buckets_.size())) {
+            buckets_.resize(f + 1);
+            f_count_.resize(f + 1, 0);
+        }
+        std::vector<std::vector<uint32_t> >& by_h = buckets_[f];
+        if (h >= static_cast<int>(by_h.size())) by_h.resize(h + 1);
+        by_h[h].push_back(node);
+        f_count_[f]++;
+        if (f < min_f_) min_f_ = f;
+
+        size_++;
+        stats_.pushes++;
+        if (size_ > stats_.peak) stats_.peak = size_;
+    }
+
+    /**
+     * @brief Removes and returns the best node index; the list must not be empty
+     */
+    uint32_t pop() {
+        while (f_count_[min_f_] == 0) min_f_++;
+        std::vector<std::vector<uint32_t> >& by_h = buckets_[min_f_];
+        size_t h = 0;
+        while (by_h[h].empty()) h++;
+        uint32_t node = by_h[h].back();
+        by_h[h].pop_back();
+        f_count_[min_f_]--;
+
+        size_--;
+        stats_.pops++;
+        return node;
+    }
+
+    int minF() {
+        while (f_count_[min_f_] == 0) min_f_++;
+        return min_f_;
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    void markStale() { stats_.stale++; }
+
+    /**
+     * @brief Empties all buckets (keeping their capacity) and resets statistics
+     */
+    void clear() {
+        for (size_t f = 0; f < buckets_.size(); f++) {
+            for (size_t h = 0; h < buckets_[f].size(); h++) buckets_[f][h].clear();
+            f_count_[f] = 0;
+        }
+        min_f_ = 0;
+        size_ = 0;
+        stats_.pushes = stats_.pops = stats_.stale = stats_.peak = 0;
+    }
+
+    OpenListStats stats() const { return stats_; }
+};
+
+} // namespace puzzle
+
+#endif // OPEN_LIST_H
@@ -0,0 +1,249 @@
+/**
+ * @file pdb_builder.cpp
+ * @brief Builds disjoint additive pattern databases (.pdb) by retrograde BFS
+ *
+ * For each pattern the builder runs a 0-1 BFS backward from the goal over the
+ * abstract states (positions of the pattern tiles + position of the blank).
+ * Moving the blank into a non-pattern cell costs 0, sliding a pattern tile
+ * costs 1. A placement's value is the minimum over all blank positions, stored
+ * as a nibble in the format described in pattern_db.h.
+ *
+ * Input: N_size output_file [pattern ...]
+ * A pattern is a list of tile letters, e.g. "AEFIJM". Without patterns the
+ * default split is used: 4-4 for 3x3, 6-6-3 for 4x4, 4-4-4-4-4-4 for 5x5.
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O2 -o pdb_builder pdb_builder.cpp
+ *
+ * Usage example:
+ *      ./pdb_builder 4 pdb_4x4.pdb
+ *      ./pdb_builder 4 custom.pdb AEFIJM GHKLNO BCD
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include "pattern_db.h"
+#include "move_tables.h"
+
+using namespace std;
+using namespace puzzle;
+
+/**
+ * @brief Default disjoint split for an n x n board, as tile letter groups
+ */
+vector<string> defaultPatterns(int n) {
+    if (n == 3) return {"ABCD", "EFGH"};
+    if (n == 4) return {"AEFIJM", "GHKLNO", "BCD"};
+    if (n == 5) return {"ABFG", "CDHI", "EJOT", "KLPQ", "MNRS", "UVWX"};
+    return {};
+}
+
+/**
+ * @brief Retrograde 0-1 BFS for one pattern; returns the nibble-packed table
+ */
+vector<uint8_t> buildPattern(int n, const vector<int>& tiles, int& max_value, uint64_t& saturated) {
+    int cells = n * n;
+    int k = (int)tiles.size();
+    uint64_t states = placementCount(cells, k + 1);
+    uint64_t entries = placementCount(cells, k);
+    int blank_base = cells - k;   // radix of the blank's digit
+
+    vector<uint8_t> dist(states, 0xFF);
+    vector<uint32_t> current, next;
+
+    int pos[PDB_MAX_PATTERN + 1];
+    for (int i = 0; i < k; i++) pos[i] = tiles[i] - 1;
+    pos[k] = cells - 1;
+    uint64_t goal = rankPositions(pos, k + 1, cells);
+    dist[goal] = 0;
+    current.push_back((uint32_t)goal);
+
+    const MoveTable& moves = moveTableFor(n);
+    int occupant[64];
+
+    for (int d = 0; !current.empty(); d++) {
+        // `current` grows while it is scanned: 0-cost moves stay in layer d
+        for (size_t q = 0; q < current.size(); q++) {
+            uint64_t idx = current[q];
+            if (dist[idx] != d) continue;   // settled at a lower cost already
+            unrankPositions(idx, k + 1, cells, pos);
+
+            for (int c = 0; c < cells; c++) occupant[c] = -1;
+            int below_blank = 0;
+            for (int i = 0; i < k; i++) {
+                occupant[pos[i]] = i;
+                if (pos[i] < pos[k]) below_blank++;
+            }
+
+            int blank = pos[k];
+            const BlankMoves& legal = moves.at(blank);
+            for (int m = 0; m < legal.count; m++) {
+                int target = legal.target[m];
+                int slot = occupant[target];
+
+                if (slot < 0) {
+                    // Blank moves through a free cell: only its own digit changes
+                    int below_target = 0;
+                    for (int i = 0; i < k; i++) if (pos[i] < target) below_target++;
+                    uint64_t nidx = idx - (uint64_t)(blank - below_blank)
+                                        + (uint64_t)(target - below_target);
+                    if (dist[nidx] > d) {
+                        dist[nidx] = (uint8_t)d;
+                        current.push_back((uint32_t)nidx);
+                    }
+                } else {
+                    pos[slot] = blank;
+                    pos[k] = target;
+                    uint64_t nidx = rankPositions(pos, k + 1, cells);
+                    pos[slot] = target;
+                    pos[k] = blank;
+                    if (dist[nidx] == 0xFF) {
+                        dist[nidx] = (uint8_t)(d + 1);
+                        next.push_back((uint32_t)nidx);
+                    }
+                }
+            }
+        }
+        current.swap(next);
+        next.clear();
+    }
+
+    // Collapse the blank digit (contiguous block of blank_base entries) and
+    // keep only the part above the pattern's Manhattan distance
+    vector<uint8_t> packed((entries + 1) / 2, 0);
+    max_value = 0;
+    saturated = 0;
+    for (uint64_t e = 0; e < entries; e++) {
+        int best = 0xFF;
+        for (int b = 0; b < blank_base; b++) {
+            int v = dist[e * blank_base + b];
+            if (v < best) best = v;
+        }
+        if (best > max_value) max_value = best;
+
+        unrankPositions(e, k, cells, pos);
+        int md = 0;
+        for (int i = 0; i < k; i++) {
+            md += abs(pos[i] / n - (tiles[i] - 1) / n) + abs(pos[i] % n - (tiles[i] - 1) % n);
+        }
+        int extra = (best == 0xFF || best < md) ? 0 : (best - md) / 2;
+        if (extra > 15) {
+            extra = 15;
+            saturated++;
+        }
+        packed[e >> 1] |= (uint8_t)(extra << ((e & 1) * 4));
+    }
+    return packed;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <N_size> <output.pdb> [pattern ...]" << endl;
+        return 1;
+    }
+    int n = atoi(argv[1]);
+    string output = argv[2];
+    int cells = n * n;
+    if (!fitsBoard<uint64_t>(n) && !fitsBoard<uint128_t>(n)) {
+        cerr << "Error: Unsupported board size " << n << " (supported: 2..5)" << endl;
+        return 1;
+    }
+
+    vector<string> groups;
+    for (int i = 3; i < argc; i++) groups.push_back(argv[i]);
+    if (groups.empty()) groups = defaultPatterns(n);
+    if (groups.empty()) {
+        cerr << "Error: No default patterns for N=" << n << ", pass them explicitly" << endl;
+        return 1;
+    }
+
+    // Validate: letters in range, no tile in two patterns, state space indexable
+    vector<vector<int>> patterns;
+    vector<bool> used(cells, false);
+    for (const string& g : groups) {
+        vector<int> tiles;
+        for (char c : g) {
+            int tile = c - 'A' + 1;
+            if (tile < 1 || tile >= cells || used[tile]) {
+                cerr << "Error: Invalid or repeated tile '" << c << "' in pattern " << g << endl;
+                return 1;
+            }
+            used[tile] = true;
+            tiles.push_back(tile);
+        }
+        if (tiles.empty() || (int)tiles.size() > PDB_MAX_PATTERN ||
+            placementCount(cells, (int)tiles.size() + 1) > 0xFFFFFFFFULL) {
+            cerr << "Error: Pattern " << g << " is too large to build" << endl;
+            return 1;
+        }
+        patterns.push_back(tiles);
+    }
+
+    cout << "Building " << patterns.size() << " pattern(s) for " << n << "x" << n << endl;
+    auto total_start = chrono::high_resolution_clock::now();
+
+    vector<vector<uint8_t>> tables;
+    for (size_t p = 0; p < patterns.size(); p++) {
+        auto start = chrono::high_resolution_clock::now();
+        int max_value = 0;
+        uint64_t saturated = 0;
+        tables.push_back(buildPattern(n, patterns[p], max_value, saturated));
+        auto end = chrono::high_resolution_clock::now();
+        double ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+        cout << "pattern=" << groups[p]
+             << " tiles=" << patterns[p].size()
+             << " states=" << placementCount(cells, (int)patterns[p].size() + 1)
+             << " entries=" << placementCount(cells, (int)patterns[p].size())
+             << " bytes=" << tables.back().size()
+             << " max_value=" << max_value
+             << " saturated=" << saturated
+             << " build_ms=" << ms << endl;
+    }
+
+    // Write header, pattern table, then 8-byte aligned nibble blocks
+    PdbFileHeader header;
+    memcpy(header.magic, "PDB1", 4);
+    header.version = 1;
+    header.n = (uint32_t)n;
+    header.num_patterns = (uint32_t)patterns.size();
+
+    uint64_t offset = sizeof(PdbFileHeader) + patterns.size() * sizeof(PdbPatternHeader);
+    vector<PdbPatternHeader> pattern_headers(patterns.size());
+    for (size_t p = 0; p < patterns.size(); p++) {
+        PdbPatternHeader& ph = pattern_headers[p];
+        memset(&ph, 0, sizeof(ph));
+        ph.size = (uint32_t)patterns[p].size();
+        for (size_t i = 0; i < patterns[p].size(); i++) ph.tiles[i] = (uint8_t)patterns[p][i];
+        ph.entries = placementCount(cells, (int)patterns[p].size());
+        offset = (offset + 7) & ~7ULL;
+        ph.offset = offset;
+        offset += tables[p].size();
+    }
+
+    ofstream out(output, ios::binary);
+    if (!out) {
+        cerr << "Error: Cannot write " << output << endl;
+        return 1;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)pattern_headers.data(), pattern_headers.size() * sizeof(PdbPatternHeader));
+    uint64_t written = sizeof(PdbFileHeader) + patterns.size() * sizeof(PdbPatternHeader);
+    for (size_t p = 0; p < patterns.size(); p++) {
+        while (written < pattern_headers[p].offset) {
+            out.put(0);
+            written++;
+        }
+        out.write((const char*)tables[p].data(), tables[p].size());
+        written += tables[p].size();
+    }
+    out.close();
+
+    auto total_end = chrono::high_resolution_clock::now();
+    double total_ms = chrono::duration_cast<chrono::microseconds>(total_end - total_start).count() / 1000.0;
+    cout << "Wrote " << output << " (" << written << " bytes) in " << total_ms << " ms" << endl;
+    return 0;
+}
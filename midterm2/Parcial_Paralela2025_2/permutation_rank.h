@@ -0,0 +1,161 @@
+/**
+ * @file permutation_rank.h
+ * @brief Perfect hashes of permutations: partial placements (PDBs) and whole 3x3 boards
+ *
+ * Both are Lehmer codes: item i contributes the number of smaller items not
+ * used yet, in a base that shrinks by one per item. The "not used yet" count
+ * is a popcount over a bitmask of the items already placed, so a rank costs
+ * O(k) instead of the O(k^2) of comparing against every earlier item.
+ *
+ * rankPositions numbers the placements of k distinct tiles on C cells densely
+ * in [0, C!/(C-k)!), which is how pattern databases are indexed.
+ * rankEightPuzzle numbers the 9!/2 solvable 3x3 boards densely, so a search
+ * over the whole 3x3 state space can keep per-state data in a flat array or a
+ * bitset (RankedStateSet in state_table.h) instead of a hash table.
+ */
+#ifndef PERMUTATION_RANK_H
+#define PERMUTATION_RANK_H
+
+#include <cstdint>
+
+#include "puzzle_board.h"
+
+namespace puzzle {
+
+// Without -mpopcnt, __builtin_popcount is a libgcc call: count inline instead
+inline int bitCount(uint32_t x) {
+#ifdef __POPCNT__
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return static_cast<int>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+/**
+ * @brief Number of placements of k distinct items on `cells` cells
+ */
+inline uint64_t placementCount(int cells, int k) {
+    uint64_t count = 1;
+    for (int i = 0; i < k; i++) count *= static_cast<uint64_t>(cells - i);
+    return count;
+}
+
+/**
+ * @brief Dense rank of k distinct positions in [0, cells), cells <= 32
+ *
+ * Mixed-radix Lehmer code: digit i is pos[i] minus the number of earlier
+ * positions below it, in base (cells - i). pos[0] is the most significant
+ * digit, so ranks of (k + 1) positions are ranks of the first k positions
+ * times (cells - k) plus the last digit.
+ */
+inline uint64_t rankPositions(const int* pos, int k, int cells) {
+    uint64_t rank = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < k; i++) {
+        uint32_t below = (1u << pos[i]) - 1;
+        int digit = pos[i] - bitCount(used & below);
+        used |= 1u << pos[i];
+        rank = rank * static_cast<uint64_t>(cells - i) + static_cast<uint64_t>(digit);
+    }
+    return rank;
+}
+
+/**
+ * @brief Inverse of rankPositions
+ */
+inline void unrankPositions(uint64_t rank, int k, int cells, int* pos) {
+    int digits[32];
+    for (int i = k - 1; i >= 0; i--) {
+        uint64_t base = static_cast<uint64_t>(cells - i);
+        digits[i] = static_cast<int>(rank % base);
+        rank /= base;
+    }
+    uint32_t used = 0;   // bitmask of taken cells
+    for (int i = 0; i < k; i++) {
+        int skip = digits[i];
+        int p = 0;
+        while (true) {
+            if (!((used >> p) & 1)) {
+                if (skip == 0) break;
+                skip--;
+            }
+            p++;
+        }
+        pos[i] = p;
+        used |= 1u << p;
+    }
+}
+
+static const uint32_t EIGHT_TILE_PERMUTATIONS = 20160;   // 8!/2
+static const uint32_t EIGHT_PUZZLE_STATES = 9 * EIGHT_TILE_PERMUTATIONS;
+
+/**
+ * @brief Dense index in [0, EIGHT_PUZZLE_STATES) of a solvable 3x3 board
+ *
+ * Blank position times 8!/2, plus half the Lehmer rank of the tiles in
+ * row-major order. A 3x3 board is solvable exactly when its tiles form an
+ * even permutation, and Lehmer ranks 2k and 2k+1 differ only in the order of
+ * the last two tiles, i.e. in parity, so halving numbers the even
+ * permutations densely. Unsolvable boards share the index of a solvable one.
+ */
+template <typename Word>
+inline uint32_t rankEightPuzzle(Word cells) {
+    static const uint32_t factorial[] = {5040, 720, 120, 24, 6, 2, 1, 1};
+    uint32_t rank = 0;
+    uint32_t seen = 0;
+    int blank = 0;
+    int i = 0;
+    for (int pos = 0; pos < 9; pos++, cells >>= PackedBoard<Word>::kBits) {
+        int t = static_cast<int>(cells & PackedBoard<Word>::kMask);
+        if (t == 0) {
+            blank = pos;
+            continue;
+        }
+        int digit = t - 1 - bitCount(seen & ((1u << t) - 1));
+        seen |= 1u << t;
+        rank += static_cast<uint32_t>(digit) * factorial[i++];
+    }
+    return static_cast<uint32_t>(blank) * EIGHT_TILE_PERMUTATIONS + rank / 2;
+}
+
+/**
+ * @brief Inverse of rankEightPuzzle: the solvable board with index @p index
+ */
+template <typename Word>
+PackedBoard<Word> unrankEightPuzzle(uint32_t index) {
+    static const uint32_t factorial[] = {5040, 720, 120, 24, 6, 2, 1, 1};
+    uint32_t rank = (index % EIGHT_TILE_PERMUTATIONS) * 2;
+    int tiles[8];
+    uint32_t used = 0;
+    int inversions = 0;
+    for (int i = 0; i < 8; i++) {
+        int skip = static_cast<int>(rank / factorial[i]);
+        rank %= factorial[i];
+        inversions += skip;   // smaller tiles still to come
+        int t = 0;   // the (skip + 1)-th unused tile
+        do {
+            t++;
+            while ((used >> t) & 1) t++;
+        } while (skip-- > 0);
+        tiles[i] = t;
+        used |= 1u << t;
+    }
+    if (inversions % 2 != 0) {
+        int t = tiles[6];
+        tiles[6] = tiles[7];
+        tiles[7] = t;
+    }
+
+    PackedBoard<Word> board;
+    board.blank = static_cast<int>(index / EIGHT_TILE_PERMUTATIONS);
+    for (int pos = 0, i = 0; pos < 9; pos++) {
+        if (pos != board.blank) board.setTile(pos, tiles[i++]);
+    }
+    return board;
+}
+
+} // namespace puzzle
+
+#endif // PERMUTATION_RANK_H
@@ -0,0 +1,544 @@
+/**
+ * @file puzzle_bench.cpp
+ * @brief Benchmark harness for the sequential solvers, linked against the solver core
+ *
+ * The task_1x scripts time one process per puzzle with `date +%s.%3N`, so
+ * process start-up and CSV parsing swamp anything under a few milliseconds.
+ * This harness loads the boards once, builds each solver once (PDB heuristics
+ * included) and then times solve() calls in-process with steady_clock:
+ *
+ *   for every algorithm of --algo and every thread count of --threads:
+ *       --warmup untimed sweeps over the corpus (faults in the arenas and
+ *       tables, warms the caches), then --trials timed passes.
+ *
+ * A sweep solves every solvable board once; with T threads, T solvers take
+ * boards from a shared counter, as puzzle_solver --threads does. Unsolvable
+ * boards are skipped at load time. A small corpus sweeps in well under a
+ * millisecond, where timer and scheduler noise alone moves the result by tens
+ * of percent, so a timed pass repeats the sweep until it lasts --min-pass-ms
+ * (default 50) and reports the time per sweep. For each configuration the
+ * harness reports that pass time (median, p95, p99, min, mean over the
+ * trials) and the time of a single solve (same statistics over every solve
+ * timed), plus the nodes expanded per sweep, which must not change.
+ *
+ * --json FILE writes the results, one configuration per line of the
+ * "results" array. --baseline FILE reads such a file and compares the minimum
+ * pass time of every configuration found in both, since noise only ever adds
+ * time: a configuration slower than the baseline by more than --tolerance
+ * percent (default 10) is a regression, and the exit status is 2. A different
+ * node count means the search itself changed, so that configuration is
+ * reported as "work changed" instead. Repeating and taking the minimum
+ * removes per-call jitter, not a slower machine: on a shared or single-core
+ * VM, steal time and frequency changes still move the minimum by 20-40%
+ * between runs. Compare against a baseline taken on the same idle host with
+ * the same corpus and build flags, and widen --tolerance where that cannot be
+ * had.
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O3 -pthread -o puzzle_bench puzzle_bench.cpp
+ *
+ * Usage example:
+ *      ./puzzle_bench puzzles.txt 4 --algo astar-h1,ida --trials 10 --json bench_4x4.json
+ *      ./puzzle_bench puzzles.txt 4 --algo ida-pdb --pdb pdb_4x4.pdb --threads 1,2,4
+ *      ./puzzle_bench puzzles.txt 4 --algo astar-h1,ida --baseline bench_4x4.json
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "solver_algorithms.h"
+#include "puzzle_io.h"
+
+using namespace std;
+using namespace puzzle;
+
+struct BenchOptions : SolverConfig {
+    string puzzles_file;
+    bool binary_input;
+    int warmup;
+    int trials;
+    double min_pass_ms;
+};
+
+/**
+ * @brief Order statistics of a set of samples (nearest-rank percentiles)
+ */
+struct Summary {
+    double median, p95, p99, min, mean;
+};
+
+Summary summarize(vector<double> samples) {
+    Summary s = Summary();
+    if (samples.empty()) return s;
+    sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    auto rank = [&](double p) {
+        size_t k = (size_t)ceil(p / 100.0 * (double)count);
+        return samples[k > 0 ? k - 1 : 0];
+    };
+    s.median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    s.p95 = rank(95);
+    s.p99 = rank(99);
+    s.min = samples[0];
+    double sum = 0.0;
+    for (double x : samples) sum += x;
+    s.mean = sum / (double)count;
+    return s;
+}
+
+/**
+ * @brief One configuration: algorithm x board size x thread count
+ */
+struct BenchResult {
+    string algorithm;
+    int n;
+    int threads;
+    size_t boards;            // solvable boards timed per pass
+    size_t skipped;           // unsolvable boards left out
+    int repeats;              // sweeps per timed pass
+    long long nodes;          // nodes expanded per sweep
+    size_t limited;           // boards that hit the solver's state limit
+    bool nodes_stable;        // every sweep expanded the same nodes
+    Summary pass_ms;          // wall time of one sweep over the corpus
+    Summary solve_us;         // time of one solve() call
+
+    BenchResult() : n(0), threads(1), boards(0), skipped(0), repeats(1), nodes(0), limited(0), nodes_stable(true),
+                    pass_ms(), solve_us() {}
+};
+
+/**
+ * @brief Solvable boards of the corpus; false (with @p error) on a bad file or board
+ */
+template <typename Word>
+bool loadCorpus(const BenchOptions& o, vector<PackedBoard<Word> >& boards, size_t& skipped, string& error) {
+    ifstream file(o.puzzles_file, ios::binary);
+    if (!file.is_open()) {
+        error = "Cannot open file " + o.puzzles_file;
+        return false;
+    }
+    BoardReader<Word> input(file, o.n, o.binary_input);
+    PackedBoard<Word> board;
+    bool valid = false;
+    skipped = 0;
+    while (input.next(board, valid)) {
+        if (!valid) {
+            error = "Invalid " + to_string(o.n) + "x" + to_string(o.n) + " board '" + input.text(board, valid) + "'";
+            return false;
+        }
+        if (isSolvable(board, o.n)) boards.push_back(board);
+        else skipped++;
+    }
+    if (!input.ok()) {
+        error = input.error();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief One sweep over @p boards with one solver per thread; returns the wall time in ms
+ *
+ * @p solve_ns receives the time of each board's solve() call.
+ */
+template <typename Word, typename Solver>
+double runPass(vector<unique_ptr<Solver> >& solvers, const vector<PackedBoard<Word> >& boards,
+               vector<double>& solve_ns, long long& nodes, size_t& limited) {
+    size_t threads = solvers.size();
+    vector<long long> worker_nodes(threads, 0);
+    vector<size_t> worker_limited(threads, 0);
+    atomic<size_t> next(0);
+
+    auto work = [&](size_t worker) {
+        Solver& solver = *solvers[worker];
+        for (size_t i = next++; i < boards.size(); i = next++) {
+            double ms = 0.0;
+            auto start = chrono::steady_clock::now();
+            int length = solver.solve(boards[i], ms);
+            auto end = chrono::steady_clock::now();
+            solve_ns[i] = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+            worker_nodes[worker] += solver.getNodesExpanded();
+            if (length == SOLUTION_LIMIT) worker_limited[worker]++;
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    if (threads == 1) {
+        work(0);
+    } else {
+        vector<thread> pool;
+        for (size_t t = 0; t < threads; t++) pool.emplace_back(work, t);
+        for (thread& th : pool) th.join();
+    }
+    auto end = chrono::steady_clock::now();
+
+    nodes = 0;
+    limited = 0;
+    for (size_t t = 0; t < threads; t++) {
+        nodes += worker_nodes[t];
+        limited += worker_limited[t];
+    }
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+template <typename Word, typename Algorithm>
+bool benchWith(const BenchOptions& o, int threads, BenchResult& result) {
+    typedef typename Algorithm::Solver Solver;
+    vector<PackedBoard<Word> > boards;
+    string error;
+    if (!loadCorpus(o, boards, result.skipped, error)) {
+        cerr << "Error: " << error << endl;
+        return false;
+    }
+    if (boards.empty()) {
+        cerr << "Error: no solvable boards in " << o.puzzles_file << " to time" << endl;
+        return false;
+    }
+    vector<unique_ptr<Solver> > solvers;
+    for (int t = 0; t < threads; t++) solvers.emplace_back(Algorithm::create(o));
+
+    vector<double> solve_ns(boards.size(), 0.0);
+    vector<double> pass_ms, solve_us;
+    long long nodes = 0;
+    for (int i = 0; i < o.warmup; i++) runPass(solvers, boards, solve_ns, nodes, result.limited);
+    // Size the timed passes: grow the sweep count until a batch lasts min_pass_ms
+    for (;;) {
+        double batch_ms = 0.0;
+        for (int r = 0; r < result.repeats; r++) batch_ms += runPass(solvers, boards, solve_ns, nodes, result.limited);
+        if (batch_ms >= o.min_pass_ms) break;
+        double scale = 1.2 * o.min_pass_ms / max(batch_ms, 1e-3);
+        result.repeats = (int)ceil(result.repeats * min(scale, 10.0));
+    }
+    result.nodes = nodes;
+    for (int i = 0; i < o.trials; i++) {
+        double total_ms = 0.0;
+        for (int r = 0; r < result.repeats; r++) {
+            total_ms += runPass(solvers, boards, solve_ns, nodes, result.limited);
+            for (double ns : solve_ns) solve_us.push_back(ns / 1000.0);
+            if (nodes != result.nodes) result.nodes_stable = false;
+            result.nodes = nodes;
+        }
+        pass_ms.push_back(total_ms / result.repeats);
+    }
+    result.boards = boards.size();
+    result.pass_ms = summarize(pass_ms);
+    result.solve_us = summarize(solve_us);
+    return true;
+}
+
+// dispatchBoardSize picks the instantiation of Algorithm for the board size
+template <template <typename, int> class Algorithm>
+struct BenchRunner {
+    template <typename Word, int Side>
+    struct For {
+        static bool run(const BenchOptions& o, int threads, BenchResult& result) {
+            return benchWith<Word, Algorithm<Word, Side> >(o, threads, result);
+        }
+    };
+};
+
+template <template <typename, int> class Algorithm>
+bool benchAlgorithm(const BenchOptions& o, int threads, BenchResult& result) {
+    return dispatchBoardSize<BenchRunner<Algorithm>::template For>(o.n, o, threads, result);
+}
+
+struct BenchEntry {
+    const char* name;    // --algo value, as in puzzle_solver
+    bool needs_pdb;
+    bool needs_table;    // 3x3 only, table built in memory
+    bool (*run)(const BenchOptions&, int, BenchResult&);
+};
+
+static const BenchEntry ALGORITHMS[] = {
+    {"bfs",       false, false, benchAlgorithm<BfsAlgorithm>},
+    {"bibfs",     false, false, benchAlgorithm<BiBfsAlgorithm>},
+    {"astar-h1",  false, false, benchAlgorithm<AStarH1Algorithm>},
+    {"astar-h2",  false, false, benchAlgorithm<AStarH2Algorithm>},
+    {"astar-pdb", true,  false, benchAlgorithm<AStarPdbAlgorithm>},
+    {"ida",       false, false, benchAlgorithm<IdaAlgorithm>},
+    {"ida-pdb",   true,  false, benchAlgorithm<IdaPdbAlgorithm>},
+    {"table",     false, true,  benchAlgorithm<TableAlgorithm>},
+};
+static const int NUM_ALGORITHMS = sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]);
+
+const BenchEntry* findAlgorithm(const string& name) {
+    for (int i = 0; i < NUM_ALGORITHMS; i++) {
+        if (name == ALGORITHMS[i].name) return &ALGORITHMS[i];
+    }
+    return nullptr;
+}
+
+vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+string jsonSummary(const Summary& s) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "{\"median\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"min\": %.4f, \"mean\": %.4f}",
+             s.median, s.p95, s.p99, s.min, s.mean);
+    return buffer;
+}
+
+/**
+ * @brief Writes the results as JSON, one configuration per line (see readBaseline)
+ */
+bool writeJson(const string& path, const BenchOptions& o, const vector<BenchResult>& results) {
+    ofstream out(path);
+    if (!out.is_open()) return false;
+    out << "{\n"
+        << "  \"tool\": \"puzzle_bench\",\n"
+#ifdef __VERSION__
+        << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+#endif
+        << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n"
+        << "  \"corpus\": \"" << o.puzzles_file << "\",\n"
+        << "  \"warmup\": " << o.warmup << ",\n"
+        << "  \"trials\": " << o.trials << ",\n"
+        << "  \"min_pass_ms\": " << o.min_pass_ms << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"algorithm\": \"" << r.algorithm << "\", \"n\": " << r.n << ", \"threads\": " << r.threads
+            << ", \"boards\": " << r.boards << ", \"skipped\": " << r.skipped << ", \"repeats\": " << r.repeats
+            << ", \"limited\": " << r.limited
+            << ", \"nodes\": " << r.nodes << ", \"nodes_stable\": " << (r.nodes_stable ? "true" : "false")
+            << ", \"pass_ms\": " << jsonSummary(r.pass_ms) << ", \"solve_us\": " << jsonSummary(r.solve_us) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    out.close();
+    return !out.fail();
+}
+
+// Text after `"key": ` in @p line, starting the search at @p from; npos if absent
+size_t jsonValue(const string& line, const string& key, size_t from = 0) {
+    size_t pos = line.find("\"" + key + "\": ", from);
+    return pos == string::npos ? pos : pos + key.size() + 4;
+}
+
+/**
+ * @brief Reads the results of a puzzle_bench JSON file; false if it has none
+ *
+ * Relies on the layout writeJson produces (one result object per line), not
+ * on a general JSON parser.
+ */
+bool readBaseline(const string& path, vector<BenchResult>& baseline) {
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        size_t algo = jsonValue(line, "algorithm");
+        size_t n = jsonValue(line, "n");
+        size_t threads = jsonValue(line, "threads");
+        size_t nodes = jsonValue(line, "nodes");
+        size_t pass = jsonValue(line, "pass_ms");
+        size_t fastest = pass == string::npos ? pass : jsonValue(line, "min", pass);
+        if (algo == string::npos || n == string::npos || threads == string::npos || nodes == string::npos ||
+            fastest == string::npos || line[algo] != '"') {
+            continue;
+        }
+        BenchResult r;
+        r.algorithm = line.substr(algo + 1, line.find('"', algo + 1) - algo - 1);
+        r.n = atoi(line.c_str() + n);
+        r.threads = atoi(line.c_str() + threads);
+        r.nodes = atoll(line.c_str() + nodes);
+        r.pass_ms.min = atof(line.c_str() + fastest);
+        baseline.push_back(r);
+    }
+    return !baseline.empty();
+}
+
+/**
+ * @brief Prints current vs baseline minimum pass times; returns the number of regressions
+ */
+int compareBaseline(const vector<BenchResult>& results, const vector<BenchResult>& baseline, double tolerance) {
+    int regressions = 0;
+    printf("\n%-10s %2s %7s %12s %12s %9s  %s\n", "algorithm", "n", "threads", "base_min", "now_min", "change", "status");
+    for (const BenchResult& r : results) {
+        const BenchResult* base = nullptr;
+        for (const BenchResult& b : baseline) {
+            if (b.algorithm == r.algorithm && b.n == r.n && b.threads == r.threads) base = &b;
+        }
+        if (base == nullptr) {
+            printf("%-10s %2d %7d %12s %12.3f %9s  not in baseline\n", r.algorithm.c_str(), r.n, r.threads, "-",
+                   r.pass_ms.min, "-");
+            continue;
+        }
+        double change = base->pass_ms.min > 0.0 ? (r.pass_ms.min / base->pass_ms.min - 1.0) * 100.0 : 0.0;
+        const char* status = "ok";
+        if (base->nodes != r.nodes) {
+            status = "work changed";
+        } else if (change > tolerance) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -tolerance) {
+            status = "faster";
+        }
+        printf("%-10s %2d %7d %12.3f %12.3f %+8.1f%%  %s\n", r.algorithm.c_str(), r.n, r.threads,
+               base->pass_ms.min, r.pass_ms.min, change, status);
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    options.binary_input = false;
+    options.warmup = 1;
+    options.trials = 5;
+    options.min_pass_ms = 50.0;
+    string algo_list;
+    string thread_list = "1";
+    string pdb_file;
+    string json_file;
+    string baseline_file;
+    double tolerance = 10.0;
+    bool bad_args = argc < 3;
+    for (int i = 3; i < argc && !bad_args; i++) {
+        string arg = argv[i];
+        if (arg == "--algo" && i + 1 < argc) algo_list = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) thread_list = argv[++i];
+        else if (arg == "--warmup" && i + 1 < argc) options.warmup = atoi(argv[++i]);
+        else if (arg == "--trials" && i + 1 < argc) options.trials = atoi(argv[++i]);
+        else if (arg == "--min-pass-ms" && i + 1 < argc) options.min_pass_ms = atof(argv[++i]);
+        else if (arg == "--pdb" && i + 1 < argc) pdb_file = argv[++i];
+        else if (arg == "--no-mirror") options.mirror = false;
+        else if (arg == "--bin-in") options.binary_input = true;
+        else if (arg == "--json" && i + 1 < argc) json_file = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baseline_file = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = atof(argv[++i]);
+        else bad_args = true;
+    }
+    vector<int> thread_counts;
+    for (const string& t : splitList(thread_list)) thread_counts.push_back(atoi(t.c_str()));
+    bool bad_threads = thread_counts.empty();
+    for (int t : thread_counts) bad_threads = bad_threads || t < 1;
+    if (bad_args || bad_threads || options.warmup < 0 || options.trials < 1 || options.min_pass_ms < 0.0 ||
+        tolerance < 0.0) {
+        cerr << "Usage: " << argv[0] << " <puzzles_file> <N_size> [--algo <name,...>] [--threads <T,...>]"
+             << " [--warmup <W>] [--trials <R>] [--min-pass-ms <ms>]\n"
+             << "       [--pdb <file.pdb> [--no-mirror]] [--bin-in] [--json <results.json>]"
+             << " [--baseline <results.json> [--tolerance <percent>]]\n"
+             << "Algorithms are those of puzzle_solver --list; without --algo every algorithm"
+             << " runs (the PDB ones only with --pdb, table only for 3x3).\n";
+        return 1;
+    }
+
+    options.puzzles_file = argv[1];
+    options.n = atoi(argv[2]);
+    if (!supportedBoardSize(options.n)) {
+        cerr << "Error: Unsupported board size " << options.n << " (supported: 2..5)" << endl;
+        return 1;
+    }
+
+    vector<const BenchEntry*> entries;
+    bool any_pdb = false;
+    if (algo_list.empty()) {
+        for (int i = 0; i < NUM_ALGORITHMS; i++) {
+            if ((!ALGORITHMS[i].needs_pdb || !pdb_file.empty()) && (!ALGORITHMS[i].needs_table || options.n == 3)) {
+                entries.push_back(&ALGORITHMS[i]);
+            }
+        }
+    }
+    for (const string& name : splitList(algo_list)) {
+        const BenchEntry* entry = findAlgorithm(name);
+        if (entry == nullptr) {
+            cerr << "Error: Unknown algorithm '" << name << "' (see puzzle_solver --list)" << endl;
+            return 1;
+        }
+        entries.push_back(entry);
+    }
+    bool any_table = false;
+    for (const BenchEntry* entry : entries) {
+        any_pdb = any_pdb || entry->needs_pdb;
+        any_table = any_table || entry->needs_table;
+    }
+
+    PatternDatabase pdb;
+    if (any_pdb) {
+        string error;
+        if (pdb_file.empty()) {
+            cerr << "Error: the PDB algorithms need --pdb <file.pdb>" << endl;
+            return 1;
+        }
+        if (!pdb.load(pdb_file, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if (pdb.boardSize() != options.n) {
+            cerr << "Error: " << pdb_file << " was built for N=" << pdb.boardSize() << endl;
+            return 1;
+        }
+        options.pdb = &pdb;
+    }
+
+    EightPuzzleTable table;
+    if (any_table) {
+        if (options.n != 3) {
+            cerr << "Error: the table algorithm solves 3x3 boards only" << endl;
+            return 1;
+        }
+        table.build();
+        options.table = &table;
+    }
+
+    vector<BenchResult> baseline;
+    if (!baseline_file.empty() && !readBaseline(baseline_file, baseline)) {
+        cerr << "Error: no puzzle_bench results in " << baseline_file << endl;
+        return 1;
+    }
+
+    printf("%-10s %2s %7s %6s %10s %10s %10s %10s %10s %10s %10s %12s\n", "algorithm", "n", "threads", "boards",
+           "pass_min", "pass_med", "pass_p95", "pass_p99", "solve_med", "solve_p95", "solve_p99", "nodes");
+    printf("%-10s %2s %7s %6s %10s %10s %10s %10s %10s %10s %10s %12s\n", "", "", "", "", "ms", "ms", "ms", "ms", "us",
+           "us", "us", "");
+    vector<BenchResult> results;
+    for (const BenchEntry* entry : entries) {
+        for (int threads : thread_counts) {
+            BenchResult r;
+            r.algorithm = entry->name;
+            r.n = options.n;
+            r.threads = threads;
+            if (!entry->run(options, threads, r)) return 1;
+            printf("%-10s %2d %7d %6zu %10.3f %10.3f %10.3f %10.3f %10.2f %10.2f %10.2f %12lld%s\n",
+                   r.algorithm.c_str(), r.n, r.threads, r.boards, r.pass_ms.min, r.pass_ms.median, r.pass_ms.p95,
+                   r.pass_ms.p99, r.solve_us.median,
+                   r.solve_us.p95, r.solve_us.p99, r.nodes, r.nodes_stable ? "" : " (varies)");
+            fflush(stdout);
+            if (r.limited > 0) {
+                cerr << "Warning: " << entry->name << " hit its state limit on " << r.limited
+                     << " board(s); their times measure the limit, not a solution" << endl;
+            }
+            results.push_back(r);
+        }
+    }
+    if (!results.empty() && results[0].skipped > 0) {
+        cerr << "Skipped " << results[0].skipped << " unsolvable board(s)" << endl;
+    }
+
+    if (!json_file.empty() && !writeJson(json_file, options, results)) {
+        cerr << "Error: cannot write " << json_file << endl;
+        return 1;
+    }
+    if (!baseline.empty()) {
+        int regressions = compareBaseline(results, baseline, tolerance);
+        if (regressions > 0) {
+            printf("%d regression(s) beyond %.1f%%\n", regressions, tolerance);
+            return 2;
+        }
+    }
+    return 0;
+}
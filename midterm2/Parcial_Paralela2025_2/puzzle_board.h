@@ -0,0 +1,325 @@
+/**
+ * @file puzzle_board.h
+ * @brief Packed-integer NxN sliding puzzle board shared by all solvers
+ *
+ * A board is stored as one machine word with a fixed number of bits per cell
+ * in row-major order, cell 0 in the lowest bits. Tile 'A' is stored as 1,
+ * 'B' as 2, ... and the blank '#' as 0, so the 4x4 goal
+ * "ABCDEFGHIJKLMNO#" is the word 0x0FEDCBA987654321.
+ *
+ * Layouts:
+ *   - 3x3 and 4x4: uint64_t, 4 bits per cell (36 and 64 bits used)
+ *   - 5x5:         uint128_t, 5 bits per cell (125 bits used)
+ *
+ * Since the blank is always 0, sliding a tile into the blank is a single
+ * subtract/add of the tile value at two shifted positions; no copies of rows
+ * and no heap allocation per neighbor.
+ */
+#ifndef PUZZLE_BOARD_H
+#define PUZZLE_BOARD_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace puzzle {
+
+typedef unsigned __int128 uint128_t;
+
+/**
+ * @brief Per-word layout parameters (bits per cell and largest board side)
+ */
+template <typename Word> struct WordTraits;
+
+template <> struct WordTraits<uint64_t> {
+    static const int kBits = 4;
+    static const int kMaxSide = 4;
+};
+
+template <> struct WordTraits<uint128_t> {
+    static const int kBits = 5;
+    static const int kMaxSide = 5;
+};
+
+/**
+ * @brief NxN board packed into a single word plus the cached blank position
+ */
+template <typename Word>
+struct PackedBoard {
+    static const int kBits = WordTraits<Word>::kBits;
+    static const int kMask = (1 << kBits) - 1;
+
+    Word cells;
+    int blank;
+
+    PackedBoard() : cells(0), blank(0) {}
+
+    int tile(int pos) const {
+        return static_cast<int>((cells >> (kBits * pos)) & kMask);
+    }
+
+    void setTile(int pos, int value) {
+        cells &= ~(static_cast<Word>(kMask) << (kBits * pos));
+        cells |= static_cast<Word>(value) << (kBits * pos);
+    }
+
+    /**
+     * @brief Slides the tile at position @p from into the blank
+     *
+     * The blank moves to @p from. Returns the tile that was moved.
+     */
+    int slide(int from) {
+        Word tile_bits = (cells >> (kBits * from)) & kMask;
+        cells -= tile_bits << (kBits * from);
+        cells += tile_bits << (kBits * blank);
+        blank = from;
+        return static_cast<int>(tile_bits);
+    }
+
+    bool operator==(const PackedBoard& other) const { return cells == other.cells; }
+    bool operator!=(const PackedBoard& other) const { return cells != other.cells; }
+    bool operator<(const PackedBoard& other) const { return cells < other.cells; }
+};
+
+/**
+ * @brief True if an n x n board fits in the given word layout
+ */
+template <typename Word>
+inline bool fitsBoard(int n) {
+    return n >= 2 && n <= WordTraits<Word>::kMaxSide;
+}
+
+/**
+ * @brief A board dimension (side or cell count) fixed at compile time, or 0 for runtime
+ *
+ * Solvers hold their side as a BoardDim<Side> member and use it like an int.
+ * With Side > 0 the value is a constant, so `pos / N`, `pos % N`, the bounds
+ * checks and the table strides fold into shifts and immediates, and loops
+ * over N unroll. BoardDim<0> stores the side given at construction.
+ */
+template <int Value>
+struct BoardDim {
+    explicit BoardDim(int) {}
+    operator int() const { return Value; }
+};
+
+template <>
+struct BoardDim<0> {
+    int value;
+    explicit BoardDim(int v) : value(v) {}
+    operator int() const { return value; }
+};
+
+/**
+ * @brief True if some word layout holds an n x n board
+ */
+inline bool supportedBoardSize(int n) {
+    return fitsBoard<uint64_t>(n) || fitsBoard<uint128_t>(n);
+}
+
+/**
+ * @brief Returns Run<Word, Side>::run(args...) for an n x n board
+ *
+ * 3x3, 4x4 and 5x5 get their own instantiation with the side fixed at compile
+ * time; any other supported size runs the generic code (Side = 0). Callers
+ * check supportedBoardSize(n) first.
+ */
+template <template <typename, int> class Run, typename... Args>
+bool dispatchBoardSize(int n, Args&&... args) {
+    switch (n) {
+    case 3: return Run<uint64_t, 3>::run(std::forward<Args>(args)...);
+    case 4: return Run<uint64_t, 4>::run(std::forward<Args>(args)...);
+    case 5: return Run<uint128_t, 5>::run(std::forward<Args>(args)...);
+    default: return Run<uint64_t, 0>::run(std::forward<Args>(args)...);
+    }
+}
+
+/**
+ * @brief Goal board: tiles 1..n*n-1 in order, blank in the last cell
+ */
+template <typename Word>
+PackedBoard<Word> goalBoard(int n) {
+    PackedBoard<Word> goal;
+    for (int pos = 0; pos < n * n - 1; pos++) {
+        goal.setTile(pos, pos + 1);
+    }
+    goal.blank = n * n - 1;
+    return goal;
+}
+
+/**
+ * @brief Parses a row-major board string ("ABC...#") into a packed board
+ *
+ * Returns false if the string has the wrong length, contains a character
+ * outside 'A'..'A'+n*n-2 and '#', or does not contain exactly one blank.
+ */
+template <typename Word>
+bool parseBoard(const std::string& str, int n, PackedBoard<Word>& out) {
+    int cells = n * n;
+    if (!fitsBoard<Word>(n) || static_cast<int>(str.size()) != cells) return false;
+
+    out = PackedBoard<Word>();
+    int blanks = 0;
+    for (int pos = 0; pos < cells; pos++) {
+        char c = str[pos];
+        if (c == '#') {
+            out.blank = pos;
+            blanks++;
+        } else if (c >= 'A' && c < 'A' + cells - 1) {
+            out.setTile(pos, c - 'A' + 1);
+        } else {
+            return false;
+        }
+    }
+    return blanks == 1;
+}
+
+/**
+ * @brief Inverse of parseBoard
+ */
+template <typename Word>
+std::string boardToString(const PackedBoard<Word>& board, int n) {
+    std::string result(n * n, '#');
+    for (int pos = 0; pos < n * n; pos++) {
+        int t = board.tile(pos);
+        if (t != 0) result[pos] = static_cast<char>('A' + t - 1);
+    }
+    return result;
+}
+
+/**
+ * @brief Validates a packed word read from a file and locates its blank
+ *
+ * Returns false unless every cell value in [0, n*n) appears exactly once and
+ * the bits above the last cell are zero. The all-zero word is never valid.
+ */
+template <typename Word>
+bool unpackBoard(Word cells, int n, PackedBoard<Word>& out) {
+    typedef PackedBoard<Word> Board;
+    int count = n * n;
+    if (!fitsBoard<Word>(n)) return false;
+    if (Board::kBits * count < static_cast<int>(8 * sizeof(Word)) && (cells >> (Board::kBits * count)) != 0) {
+        return false;
+    }
+
+    out.cells = cells;
+    uint32_t seen = 0;
+    for (int pos = 0; pos < count; pos++) {
+        int t = out.tile(pos);
+        if (t >= count || (seen >> t) & 1) return false;
+        seen |= 1u << t;
+        if (t == 0) out.blank = pos;
+    }
+    return true;
+}
+
+/**
+ * @brief Cell @p pos reflected in the main diagonal: (row, col) -> (col, row)
+ */
+inline int transposeCell(int pos, int n) {
+    return (pos % n) * n + pos / n;
+}
+
+/**
+ * @brief Reflection of @p board in the main diagonal, tiles relabeled to match
+ *
+ * Every cell moves to its transposed cell and every tile is renamed after the
+ * transposed cell of its goal position, so the goal maps to itself and a
+ * blank move UP/DOWN becomes LEFT/RIGHT (mirrorMove). A board and its mirror
+ * are therefore equally far from the goal: solutions, cached results and
+ * lower bounds carry over from one to the other.
+ */
+template <typename Word>
+PackedBoard<Word> mirrorBoard(const PackedBoard<Word>& board, int n) {
+    PackedBoard<Word> mirror;
+    for (int pos = 0; pos < n * n; pos++) {
+        int t = board.tile(pos);
+        if (t != 0) mirror.setTile(transposeCell(pos, n), transposeCell(t - 1, n) + 1);
+    }
+    mirror.blank = transposeCell(board.blank, n);
+    return mirror;
+}
+
+/**
+ * @brief The smaller word of @p board and its mirror; @p mirrored tells which
+ */
+template <typename Word>
+PackedBoard<Word> canonicalBoard(const PackedBoard<Word>& board, int n, bool& mirrored) {
+    PackedBoard<Word> mirror = mirrorBoard(board, n);
+    mirrored = mirror.cells < board.cells;
+    return mirrored ? mirror : board;
+}
+
+/**
+ * @brief solution_length values that are not a number of moves
+ *
+ * Solvers check parity before searching, so an unsolvable board costs
+ * O(n^2) and is never confused with a search that ran out of budget.
+ */
+static const int SOLUTION_LIMIT = -1;        // search stopped at its state/node limit
+static const int SOLUTION_UNSOLVABLE = -2;   // wrong permutation parity, not searched
+
+/**
+ * @brief Number of tile pairs (a, b) with a before b in row-major order and a > b
+ *
+ * One pass over the cells: `seen` has bit t set for every tile already
+ * passed, so the larger tiles ahead of the current one are a popcount.
+ */
+template <typename Word>
+int countInversions(const PackedBoard<Word>& board, int n) {
+    int inversions = 0;
+    uint32_t seen = 0;
+    for (int pos = 0; pos < n * n; pos++) {
+        int t = board.tile(pos);
+        if (t == 0) continue;
+        inversions += __builtin_popcount(seen >> t);
+        seen |= 1u << t;
+    }
+    return inversions;
+}
+
+/**
+ * @brief Parity test: true if @p board can reach the goal at all
+ *
+ * Odd n: the inversion count must be even. Even n: inversions plus the blank's
+ * row counted from the bottom (1-based) must be odd.
+ */
+template <typename Word>
+bool isSolvable(const PackedBoard<Word>& board, int n) {
+    int inversions = countInversions(board, n);
+    if (n % 2 == 1) return inversions % 2 == 0;
+    int blank_row_from_bottom = n - board.blank / n;
+    return (inversions + blank_row_from_bottom) % 2 == 1;
+}
+
+/**
+ * @brief splitmix64 finalizer, used to spread packed boards over hash buckets
+ */
+inline uint64_t mixBits(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t hashWord(uint64_t w) { return mixBits(w); }
+
+inline uint64_t hashWord(uint128_t w) {
+    return mixBits(static_cast<uint64_t>(w) ^ mixBits(static_cast<uint64_t>(w >> 64)));
+}
+
+/**
+ * @brief Hash functor so packed boards/words can key std::unordered_* containers
+ */
+struct PackedHash {
+    template <typename Word>
+    size_t operator()(const PackedBoard<Word>& b) const { return hashWord(b.cells); }
+    size_t operator()(uint64_t w) const { return hashWord(w); }
+    size_t operator()(uint128_t w) const { return hashWord(w); }
+};
+
+} // namespace puzzle
+
+#endif // PUZZLE_BOARD_H
@@ -0,0 +1,255 @@
+/**
+ * @file puzzle_convert.cpp
+ * @brief Converts batch files between the text formats and the binary ones
+ *
+ * Puzzles: one board per line (puzzles.txt) <-> SPZ1 packed boards.
+ * Results: the CSV printed by the *_nsize solvers <-> SPR1 records.
+ * Formats are described in puzzle_io.h.
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O2 -o puzzle_convert puzzle_convert.cpp
+ *
+ * Usage:
+ *      ./puzzle_convert to-bin <N_size> puzzles.txt puzzles.spz
+ *      ./puzzle_convert to-text puzzles.spz puzzles.txt
+ *      ./puzzle_convert csv-to-bin results.csv results.spr
+ *      ./puzzle_convert bin-to-csv results.spr puzzles.spz results.csv
+ *
+ * bin-to-csv needs the puzzle file (text or SPZ1) because result records do
+ * not repeat the board; records must be in puzzle order, as solvers write them.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "puzzle_io.h"
+
+using namespace std;
+using namespace puzzle;
+
+/**
+ * @brief Board side stored in an SPZ1 header, or 0 if @p path is not SPZ1
+ */
+int spzBoardSize(const string& path) {
+    ifstream in(path, ios::binary);
+    PuzzleFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return 0;
+    if (memcmp(header.magic, "SPZ1", 4) != 0) return 0;
+    return (int)header.n;
+}
+
+template <typename Word>
+bool textToBinary(ifstream& in, int n, const string& out_path) {
+    PuzzleFileWriter<Word> out;
+    string error;
+    if (!out.open(out_path, n, error)) {
+        cerr << "Error: " << error << endl;
+        return false;
+    }
+    BoardReader<Word> boards(in, n, false);
+    PackedBoard<Word> board;
+    bool valid = false;
+    long long invalid = 0;
+    while (boards.next(board, valid)) {
+        if (!valid) {
+            cerr << "Warning: line " << boards.lineNumber() << " (puzzle index " << out.count() << ") is not a " << n
+                 << "x" << n << " board, stored as invalid" << endl;
+            invalid++;
+        }
+        out.write(valid ? &board : nullptr);
+    }
+    uint64_t count = out.count();
+    if (!out.close()) {
+        cerr << "Error: cannot write " << out_path << endl;
+        return false;
+    }
+    cout << "Wrote " << count << " boards (" << invalid << " invalid) to " << out_path << endl;
+    return true;
+}
+
+template <typename Word>
+bool binaryToText(ifstream& in, int n, const string& out_path) {
+    BoardReader<Word> boards(in, n, true);
+    if (!boards.ok()) {
+        cerr << "Error: " << boards.error() << endl;
+        return false;
+    }
+    ofstream out(out_path, ios::binary);
+    if (!out) {
+        cerr << "Error: cannot write " << out_path << endl;
+        return false;
+    }
+    PackedBoard<Word> board;
+    bool valid = false;
+    long long count = 0;
+    while (boards.next(board, valid)) {
+        // An invalid record has no text; a placeholder keeps the line numbering
+        out << (valid ? boards.text(board, valid) : string("INVALID")) << '\n';
+        count++;
+    }
+    if (!boards.ok()) {
+        cerr << "Error: " << boards.error() << endl;
+        return false;
+    }
+    cout << "Wrote " << count << " boards to " << out_path << endl;
+    return true;
+}
+
+bool csvToBinary(const string& in_path, const string& out_path) {
+    ifstream in(in_path);
+    if (!in) {
+        cerr << "Error: cannot open " << in_path << endl;
+        return false;
+    }
+    string line;
+    getline(in, line);   // header
+    if (line.compare(0, 13, "puzzle_index,") != 0) {
+        cerr << "Error: " << in_path << " is not a solver CSV" << endl;
+        return false;
+    }
+
+    ResultFileWriter out;
+    long long count = 0;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        // puzzle_index,board,solution_length,execution_time_ms,nodes_expanded,solvable,algorithm[,path]
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() < 7) {
+            cerr << "Error: malformed row '" << line << "'" << endl;
+            return false;
+        }
+        if (count == 0) {
+            int n = (int)lround(sqrt((double)fields[1].size()));
+            string error;
+            if (!out.open(out_path, n, fields[6], error)) {
+                cerr << "Error: " << error << endl;
+                return false;
+            }
+        }
+        out.write(strtoull(fields[0].c_str(), nullptr, 10), atoi(fields[2].c_str()),
+                  strtod(fields[3].c_str(), nullptr), strtoull(fields[4].c_str(), nullptr, 10));
+        count++;
+    }
+    if (count == 0) {
+        cerr << "Error: " << in_path << " has no rows" << endl;
+        return false;
+    }
+    if (!out.close()) {
+        cerr << "Error: cannot write " << out_path << endl;
+        return false;
+    }
+    cout << "Wrote " << count << " records to " << out_path << endl;
+    return true;
+}
+
+template <typename Word>
+bool binaryToCsv(ResultFileReader& results, const string& puzzles_path, bool puzzles_binary,
+                 const string& out_path) {
+    int n = results.boardSize();
+    ifstream puzzles_in(puzzles_path, ios::binary);
+    BoardReader<Word> boards(puzzles_in, n, puzzles_binary);
+    if (!puzzles_in || !boards.ok()) {
+        cerr << "Error: " << (boards.ok() ? "cannot open " + puzzles_path : boards.error()) << endl;
+        return false;
+    }
+    ofstream out(out_path, ios::binary);
+    if (!out) {
+        cerr << "Error: cannot write " << out_path << endl;
+        return false;
+    }
+
+    string algorithm = results.algorithm();
+    out << "puzzle_index,board,solution_length,execution_time_ms,nodes_expanded,solvable,algorithm\n";
+    PackedBoard<Word> board;
+    bool valid = false;
+    uint64_t board_index = 0;
+    bool have_board = false;
+    ResultRecord r;
+    long long count = 0;
+    while (results.next(r)) {
+        // Advance the puzzle file to the record's board
+        while (!have_board || board_index < r.puzzle_index) {
+            if (have_board) board_index++;
+            if (!boards.next(board, valid)) {
+                cerr << "Error: result " << r.puzzle_index << " has no board in " << puzzles_path << endl;
+                return false;
+            }
+            have_board = true;
+        }
+        if (board_index != r.puzzle_index) {
+            cerr << "Error: result records are not in puzzle order" << endl;
+            return false;
+        }
+        out << r.puzzle_index << ","
+            << boards.text(board, valid) << ","
+            << r.solution_length << ","
+            << r.execution_time_ms << ","
+            << r.nodes_expanded << ","
+            << (r.solution_length >= 0 ? "true" : "false") << ","
+            << algorithm << '\n';
+        count++;
+    }
+    if (!results.ok()) {
+        cerr << "Error: " << results.error() << endl;
+        return false;
+    }
+    cout << "Wrote " << count << " rows to " << out_path << endl;
+    return true;
+}
+
+void usage(const char* prog) {
+    cerr << "Usage: " << prog << " to-bin <N_size> <puzzles.txt> <puzzles.spz>\n"
+         << "       " << prog << " to-text <puzzles.spz> <puzzles.txt>\n"
+         << "       " << prog << " csv-to-bin <results.csv> <results.spr>\n"
+         << "       " << prog << " bin-to-csv <results.spr> <puzzles.spz|puzzles.txt> <results.csv>" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    string mode = argv[1];
+    bool ok = false;
+
+    if (mode == "to-bin" && argc == 5) {
+        int n = atoi(argv[2]);
+        ifstream in(argv[3], ios::binary);
+        if (!in) {
+            cerr << "Error: cannot open " << argv[3] << endl;
+            return 1;
+        }
+        if (fitsBoard<uint64_t>(n)) ok = textToBinary<uint64_t>(in, n, argv[4]);
+        else if (fitsBoard<uint128_t>(n)) ok = textToBinary<uint128_t>(in, n, argv[4]);
+        else cerr << "Error: Unsupported board size " << n << " (supported: 2..5)" << endl;
+    } else if (mode == "to-text" && argc == 4) {
+        int n = spzBoardSize(argv[2]);
+        ifstream in(argv[2], ios::binary);
+        if (n == 0) cerr << "Error: " << argv[2] << " is not an SPZ1 puzzle file" << endl;
+        else if (fitsBoard<uint64_t>(n)) ok = binaryToText<uint64_t>(in, n, argv[3]);
+        else if (fitsBoard<uint128_t>(n)) ok = binaryToText<uint128_t>(in, n, argv[3]);
+        else cerr << "Error: " << argv[2] << " has an invalid board size" << endl;
+    } else if (mode == "csv-to-bin" && argc == 4) {
+        ok = csvToBinary(argv[2], argv[3]);
+    } else if (mode == "bin-to-csv" && argc == 5) {
+        ifstream in(argv[2], ios::binary);
+        ResultFileReader results(in);
+        int n = results.boardSize();
+        bool puzzles_binary = spzBoardSize(argv[3]) != 0;
+        if (!results.ok()) cerr << "Error: " << argv[2] << ": " << results.error() << endl;
+        else if (fitsBoard<uint64_t>(n)) ok = binaryToCsv<uint64_t>(results, argv[3], puzzles_binary, argv[4]);
+        else if (fitsBoard<uint128_t>(n)) ok = binaryToCsv<uint128_t>(results, argv[3], puzzles_binary, argv[4]);
+        else cerr << "Error: " << argv[2] << " has an invalid board size" << endl;
+    } else {
+        usage(argv[0]);
+    }
+    return ok ? 0 : 1;
+}
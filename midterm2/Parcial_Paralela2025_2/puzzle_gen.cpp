@@ -0,0 +1,341 @@
+/**
+ * @file puzzle_gen.cpp
+ * @brief Generates benchmark corpora: boards of an exact optimal depth, or uniformly random boards
+ *
+ * --depth D (or a range LO-HI) writes `count` distinct boards whose optimal
+ * solution is exactly D moves, for every depth of the range. Two methods:
+ *
+ *   bfs   Breadth-first layers from the goal. The puzzle graph is bipartite,
+ *         so layer d+1 is the neighbours of layer d minus layer d-1: only
+ *         three sorted layers are kept and no visited table is needed. The
+ *         boards are drawn uniformly from layer D. Stops when a layer would
+ *         exceed --max-layer boards.
+ *   walk  Random walks from the goal without immediate reversals, each end
+ *         board solved by IDA* (with --pdb, IDA* with the pattern database)
+ *         and kept only if its optimal depth is D. The walk length moves by
+ *         2 towards the depth that came out, so it settles where depth D is
+ *         hit often. Boards are exact-depth but not uniform over the layer.
+ *
+ * The default method, auto, runs bfs as deep as --max-layer allows and walks
+ * for the deeper part of the range.
+ *
+ * --random writes uniformly random solvable boards: a uniform permutation,
+ * with two tiles swapped when its parity is wrong (a bijection between the
+ * two halves, so the result stays uniform). Their depth is not computed.
+ *
+ * Boards go to --txt FILE (one per line, as puzzles.txt) and/or --spz FILE
+ * (SPZ1, see puzzle_io.h); with neither, text goes to stdout. The same
+ * --seed gives the same corpus.
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O3 -o puzzle_gen puzzle_gen.cpp
+ *
+ * Usage example:
+ *      ./puzzle_gen 3 100 --depth 20-31 --txt puzzles_3x3.txt
+ *      ./puzzle_gen 4 50 --depth 40 --pdb pdb_4x4.pdb --txt depth40.txt --spz depth40.spz
+ *      ./puzzle_gen 5 1000 --random --seed 7 --spz random_5x5.spz
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#include "solver_algorithms.h"
+#include "puzzle_io.h"
+#include "move_tables.h"
+
+using namespace std;
+using namespace puzzle;
+
+struct GenOptions : SolverConfig {
+    int count;                // boards per depth (--random: in total)
+    bool random;
+    int depth_lo, depth_hi;
+    string method;            // "auto", "bfs" or "walk"
+    uint64_t seed;
+    size_t max_layer;         // bfs: largest layer held in memory
+    string txt_file, spz_file;
+};
+
+/**
+ * @brief Uniformly random solvable board
+ */
+template <typename Word>
+PackedBoard<Word> randomBoard(int n, mt19937_64& rng) {
+    int cells = n * n;
+    vector<int> tiles(cells);
+    for (int i = 0; i < cells; i++) tiles[i] = i;
+    for (int i = cells - 1; i > 0; i--) {
+        swap(tiles[i], tiles[uniform_int_distribution<int>(0, i)(rng)]);
+    }
+    PackedBoard<Word> board;
+    for (int pos = 0; pos < cells; pos++) {
+        board.setTile(pos, tiles[pos]);
+        if (tiles[pos] == 0) board.blank = pos;
+    }
+    if (!isSolvable(board, n)) {
+        // Swapping the first two tiles flips the parity and pairs each
+        // unsolvable board with exactly one solvable board
+        int a = board.blank == 0 ? 1 : 0;
+        int b = board.blank <= 1 ? 2 : 1;
+        int t = board.tile(a);
+        board.setTile(a, board.tile(b));
+        board.setTile(b, t);
+    }
+    return board;
+}
+
+template <typename Word>
+int blankOf(Word cells, int n) {
+    PackedBoard<Word> board;
+    board.cells = cells;
+    for (int pos = 0; pos < n * n; pos++) {
+        if (board.tile(pos) == 0) return pos;
+    }
+    return -1;
+}
+
+/**
+ * @brief Adds @p count boards drawn uniformly from @p layer (all of it if smaller)
+ */
+template <typename Word>
+void sampleLayer(const vector<Word>& layer, int n, int count, mt19937_64& rng, vector<PackedBoard<Word> >& out) {
+    vector<Word> pool(layer);
+    size_t take = min(pool.size(), (size_t)count);
+    for (size_t i = 0; i < take; i++) {
+        swap(pool[i], pool[uniform_int_distribution<size_t>(i, pool.size() - 1)(rng)]);
+        PackedBoard<Word> board;
+        board.cells = pool[i];
+        board.blank = blankOf(pool[i], n);
+        out.push_back(board);
+    }
+}
+
+/**
+ * @brief Samples the depths of the range by BFS layers from the goal
+ *
+ * Returns the first depth it could not reach within --max-layer (depth_hi + 1
+ * if it covered the whole range). @p exhausted is set when the puzzle has no
+ * boards that deep.
+ */
+template <typename Word>
+int bfsDepths(const GenOptions& o, mt19937_64& rng, vector<PackedBoard<Word> >& out, bool& exhausted) {
+    const MoveTable& moves = moveTableFor(o.n);
+    vector<Word> prev, layer(1, goalBoard<Word>(o.n).cells), next;
+    exhausted = false;
+    for (int depth = 0;; depth++) {
+        if (depth >= o.depth_lo) {
+            size_t before = out.size();
+            sampleLayer(layer, o.n, o.count, rng, out);
+            cerr << "depth " << depth << ": " << out.size() - before << " of " << layer.size() << " boards (bfs)" << endl;
+        }
+        if (depth == o.depth_hi) return depth + 1;
+
+        next.clear();
+        for (Word cells : layer) {
+            PackedBoard<Word> board;
+            board.cells = cells;
+            board.blank = blankOf(cells, o.n);
+            const BlankMoves& legal = moves.at(board.blank);
+            for (int k = 0; k < legal.count; k++) {
+                PackedBoard<Word> child = board;
+                child.slide(legal.target[k]);
+                if (!binary_search(prev.begin(), prev.end(), child.cells)) next.push_back(child.cells);
+            }
+        }
+        sort(next.begin(), next.end());
+        next.erase(unique(next.begin(), next.end()), next.end());
+        if (next.empty()) {
+            exhausted = true;
+            return depth + 1;
+        }
+        if (next.size() > o.max_layer) return depth + 1;
+        prev.swap(layer);
+        layer.swap(next);
+    }
+}
+
+/**
+ * @brief Random walks whose end board is solved by Algorithm; keeps those at exactly @p depth
+ */
+template <typename Word, typename Algorithm>
+bool walkDepth(const GenOptions& o, int depth, mt19937_64& rng, StateTable<Word>& seen,
+               vector<PackedBoard<Word> >& out) {
+    unique_ptr<typename Algorithm::Solver> solver(Algorithm::create(o));
+    const MoveTable& moves = moveTableFor(o.n);
+    PackedBoard<Word> goal = goalBoard<Word>(o.n);
+    int length = depth;
+    long long attempts = 0;
+    long long max_attempts = 1000LL * o.count + 10000;
+    int found = 0;
+
+    while (found < o.count) {
+        if (++attempts > max_attempts) {
+            cerr << "Error: depth " << depth << ": only " << found << " distinct boards after "
+                 << max_attempts << " walks" << endl;
+            return false;
+        }
+        PackedBoard<Word> board = goal;
+        int last = MOVE_NONE;
+        for (int step = 0; step < length; step++) {
+            const BlankMoves& legal = moves.at(board.blank);
+            int choices[4], count = 0;
+            for (int k = 0; k < legal.count; k++) {
+                if (!undoes(legal.move[k], last)) choices[count++] = k;
+            }
+            int k = choices[uniform_int_distribution<int>(0, count - 1)(rng)];
+            board.slide(legal.target[k]);
+            last = legal.move[k];
+        }
+
+        double ms = 0.0;
+        int solved = solver->solve(board, ms);
+        if (solved == SOLUTION_LIMIT) continue;
+        if (solved == depth) {
+            if (seen.insert(board.cells)) {
+                out.push_back(board);
+                found++;
+            }
+        } else if (solved < depth) {
+            length += 2;
+        } else if (length > depth) {
+            length -= 2;
+        }
+    }
+    cerr << "depth " << depth << ": " << found << " boards (walk, " << attempts << " walks, final length "
+         << length << ")" << endl;
+    return true;
+}
+
+template <typename Word, int Side>
+struct Generator {
+    static bool run(const GenOptions& o) {
+        mt19937_64 rng(o.seed);
+        vector<PackedBoard<Word> > boards;
+
+        if (o.random) {
+            for (int i = 0; i < o.count; i++) boards.push_back(randomBoard<Word>(o.n, rng));
+        } else {
+            int walk_from = o.depth_lo;
+            if (o.method != "walk") {
+                bool exhausted = false;
+                walk_from = bfsDepths(o, rng, boards, exhausted);
+                if (exhausted) {
+                    cerr << "Error: no " << o.n << "x" << o.n << " board is " << walk_from
+                         << " or more moves from the goal" << endl;
+                    return false;
+                }
+                if (walk_from <= o.depth_hi && o.method == "bfs") {
+                    cerr << "Error: BFS layer " << walk_from << " exceeds --max-layer " << o.max_layer << endl;
+                    return false;
+                }
+            }
+            StateTable<Word> seen(o.count);
+            for (int depth = max(walk_from, o.depth_lo); depth <= o.depth_hi; depth++) {
+                bool ok = o.pdb != nullptr ? walkDepth<Word, IdaPdbAlgorithm<Word, Side> >(o, depth, rng, seen, boards)
+                                           : walkDepth<Word, IdaAlgorithm<Word, Side> >(o, depth, rng, seen, boards);
+                if (!ok) return false;
+            }
+        }
+        return writeBoards(o, boards);
+    }
+
+    static bool writeBoards(const GenOptions& o, const vector<PackedBoard<Word> >& boards) {
+        if (!o.spz_file.empty()) {
+            PuzzleFileWriter<Word> spz;
+            string error;
+            if (!spz.open(o.spz_file, o.n, error)) {
+                cerr << "Error: " << error << endl;
+                return false;
+            }
+            for (const PackedBoard<Word>& board : boards) spz.write(&board);
+            if (!spz.close()) {
+                cerr << "Error: cannot write " << o.spz_file << endl;
+                return false;
+            }
+        }
+        if (!o.txt_file.empty() || o.spz_file.empty()) {
+            ofstream file;
+            if (!o.txt_file.empty()) file.open(o.txt_file);
+            ostream& out = o.txt_file.empty() ? cout : file;
+            for (const PackedBoard<Word>& board : boards) out << boardToString(board, o.n) << '\n';
+            out.flush();
+            if (!out) {
+                cerr << "Error: cannot write " << (o.txt_file.empty() ? "stdout" : o.txt_file) << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// "D" or "LO-HI"
+bool parseDepths(const string& text, int& lo, int& hi) {
+    size_t dash = text.find('-');
+    lo = atoi(text.c_str());
+    hi = dash == string::npos ? lo : atoi(text.c_str() + dash + 1);
+    return !text.empty() && isdigit((unsigned char)text[0]) && lo >= 0 && hi >= lo;
+}
+
+int main(int argc, char* argv[]) {
+    GenOptions options;
+    options.random = false;
+    options.depth_lo = options.depth_hi = -1;
+    options.method = "auto";
+    options.seed = 1;
+    options.max_layer = 20000000;
+    string depth_text;
+    string pdb_file;
+    bool bad_args = argc < 3;
+    for (int i = 3; i < argc && !bad_args; i++) {
+        string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) depth_text = argv[++i];
+        else if (arg == "--random") options.random = true;
+        else if (arg == "--method" && i + 1 < argc) options.method = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) options.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-layer" && i + 1 < argc) options.max_layer = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--pdb" && i + 1 < argc) pdb_file = argv[++i];
+        else if (arg == "--txt" && i + 1 < argc) options.txt_file = argv[++i];
+        else if (arg == "--spz" && i + 1 < argc) options.spz_file = argv[++i];
+        else bad_args = true;
+    }
+    if (!bad_args) {
+        options.n = atoi(argv[1]);
+        options.count = atoi(argv[2]);
+        bad_args = options.count < 1 || options.random == !depth_text.empty() ||
+                   (!depth_text.empty() && !parseDepths(depth_text, options.depth_lo, options.depth_hi)) ||
+                   (options.method != "auto" && options.method != "bfs" && options.method != "walk");
+    }
+    if (bad_args) {
+        cerr << "Usage: " << argv[0] << " <N_size> <count> (--depth <D|LO-HI> | --random) [--seed <S>]"
+             << " [--txt <file>] [--spz <file.spz>]\n"
+             << "       [--method auto|bfs|walk] [--max-layer <boards>] [--pdb <file.pdb>]\n"
+             << "--depth writes <count> boards at each optimal depth of the range;"
+             << " --random writes <count> uniformly random solvable boards.\n";
+        return 1;
+    }
+    if (!supportedBoardSize(options.n)) {
+        cerr << "Error: Unsupported board size " << options.n << " (supported: 2..5)" << endl;
+        return 1;
+    }
+
+    PatternDatabase pdb;
+    if (!pdb_file.empty()) {
+        string error;
+        if (!pdb.load(pdb_file, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if (pdb.boardSize() != options.n) {
+            cerr << "Error: " << pdb_file << " was built for N=" << pdb.boardSize() << endl;
+            return 1;
+        }
+        options.pdb = &pdb;
+    }
+
+    return dispatchBoardSize<Generator>(options.n, options) ? 0 : 1;
+}
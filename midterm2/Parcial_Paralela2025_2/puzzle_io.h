@@ -0,0 +1,320 @@
+/**
+ * @file puzzle_io.h
+ * @brief Binary batch files: packed puzzles (SPZ1) and fixed-width results (SPR1)
+ *
+ * The text formats spend most of their bytes on formatting: a 4x4 board is a
+ * 17-byte line that has to be parsed, and every CSV row repeats the board.
+ * The binary files store the same information at fixed sizes, readable with
+ * one bulk read and no parsing.
+ *
+ * Puzzle file layout (host byte order, like the .pdb files):
+ *   PuzzleFileHeader
+ *   count packed boards, word_bytes each (8 for N <= 4, 16 for N = 5)
+ *
+ * A board is the PackedBoard word; the blank is the cell holding 0. A line of
+ * the text file that is not a valid board is stored as the all-zero word, so
+ * record i is always the i-th non-empty line and result indices agree
+ * between both formats.
+ *
+ * Result file layout:
+ *   ResultFileHeader
+ *   count ResultRecord, in the order they were written
+ *
+ * Writers patch the count into the header on close(); a file whose count
+ * was never patched (crashed writer) reads as empty.
+ */
+#ifndef PUZZLE_IO_H
+#define PUZZLE_IO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "puzzle_board.h"
+
+namespace puzzle {
+
+struct PuzzleFileHeader {
+    char magic[4];           // "SPZ1"
+    uint32_t version;        // 1
+    uint32_t n;              // board side
+    uint32_t word_bytes;     // bytes per board
+    uint64_t count;          // boards in the file
+};
+
+struct ResultFileHeader {
+    char magic[4];           // "SPR1"
+    uint32_t version;        // 1
+    uint32_t n;
+    uint32_t record_bytes;   // sizeof(ResultRecord)
+    uint64_t count;
+    char algorithm[16];      // NUL-padded, e.g. "A*-h1"
+};
+
+struct ResultRecord {
+    uint64_t puzzle_index;
+    uint64_t nodes_expanded;
+    double execution_time_ms;
+    int32_t solution_length;   // SOLUTION_UNSOLVABLE (-2), or -1: past the limits or invalid board
+    uint32_t reserved;
+};
+
+/**
+ * @brief Input/output formats picked on a solver's command line
+ */
+struct BatchFormat {
+    bool binary_input;          // the puzzles file is SPZ1
+    std::string results_file;   // write SPR1 here instead of CSV rows on stdout
+
+    BatchFormat() : binary_input(false) {}
+};
+
+/**
+ * @brief Boards of a batch, from a text file (one per line) or an SPZ1 file
+ *
+ * Text input keeps the solvers' historical rules: empty lines are skipped,
+ * other lines are parsed as they are.
+ */
+template <typename Word>
+class BoardReader {
+private:
+    static const size_t BLOCK_BOARDS = 4096;
+
+    std::istream& in_;
+    int n_;
+    bool binary_;
+    std::string line_;
+    uint64_t line_number_;         // text: lines read so far, empty ones included
+    std::string error_;
+    uint64_t remaining_;           // binary: boards not yet read from the file
+    std::vector<Word> block_;
+    size_t block_pos_;
+
+    bool refill() {
+        size_t want = remaining_ < BLOCK_BOARDS ? (size_t)remaining_ : BLOCK_BOARDS;
+        block_.resize(want);
+        block_pos_ = 0;
+        if (want == 0) return false;
+        in_.read(reinterpret_cast<char*>(block_.data()), (std::streamsize)(want * sizeof(Word)));
+        if ((size_t)in_.gcount() != want * sizeof(Word)) {
+            error_ = "truncated puzzle file";
+            block_.clear();
+            remaining_ = 0;
+            return false;
+        }
+        remaining_ -= want;
+        return true;
+    }
+
+public:
+    BoardReader(std::istream& in, int n, bool binary)
+        : in_(in), n_(n), binary_(binary), line_number_(0), remaining_(0), block_pos_(0) {
+        if (!binary_) return;
+        PuzzleFileHeader header;
+        in_.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if ((size_t)in_.gcount() != sizeof(header) || memcmp(header.magic, "SPZ1", 4) != 0 ||
+            header.version != 1) {
+            error_ = "not an SPZ1 puzzle file";
+        } else if ((int)header.n != n_ || header.word_bytes != sizeof(Word)) {
+            error_ = "puzzle file holds " + std::to_string(header.n) + "x" +
+                     std::to_string(header.n) + " boards";
+        } else {
+            remaining_ = header.count;
+        }
+    }
+
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    bool binary() const { return binary_; }
+
+    // Text input: 1-based file line of the last board returned (0 for SPZ1)
+    uint64_t lineNumber() const { return line_number_; }
+
+    /**
+     * @brief Next board; false at the end of the input (or on a read error)
+     *
+     * @p valid is false for lines / records that are not a board of size n.
+     */
+    bool next(PackedBoard<Word>& board, bool& valid) {
+        if (!binary_) {
+            while (std::getline(in_, line_)) {
+                line_number_++;
+                if (line_.empty()) continue;
+                valid = parseBoard(line_, n_, board);
+                return true;
+            }
+            return false;
+        }
+        if (block_pos_ == block_.size() && !refill()) return false;
+        board = PackedBoard<Word>();
+        valid = unpackBoard(block_[block_pos_++], n_, board);
+        return true;
+    }
+
+    /**
+     * @brief The board as text: the line as read, or the unpacked board
+     */
+    std::string text(const PackedBoard<Word>& board, bool valid) const {
+        if (!binary_) return line_;
+        return valid ? boardToString(board, n_) : std::string();
+    }
+};
+
+/**
+ * @brief Writes boards to an SPZ1 file
+ */
+template <typename Word>
+class PuzzleFileWriter {
+private:
+    FILE* file_;
+    PuzzleFileHeader header_;
+
+    PuzzleFileWriter(const PuzzleFileWriter&);
+    PuzzleFileWriter& operator=(const PuzzleFileWriter&);
+
+public:
+    PuzzleFileWriter() : file_(nullptr) {}
+    ~PuzzleFileWriter() { close(); }
+
+    bool open(const std::string& path, int n, std::string& error) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            error = "cannot write " + path;
+            return false;
+        }
+        std::setvbuf(file_, nullptr, _IOFBF, size_t(1) << 20);
+        memcpy(header_.magic, "SPZ1", 4);
+        header_.version = 1;
+        header_.n = (uint32_t)n;
+        header_.word_bytes = sizeof(Word);
+        header_.count = 0;
+        std::fwrite(&header_, sizeof(header_), 1, file_);
+        return true;
+    }
+
+    /**
+     * @brief Appends a board; pass nullptr for a line that was not a board
+     */
+    void write(const PackedBoard<Word>* board) {
+        Word cells = board != nullptr ? board->cells : Word(0);
+        std::fwrite(&cells, sizeof(cells), 1, file_);
+        header_.count++;
+    }
+
+    uint64_t count() const { return header_.count; }
+
+    /**
+     * @brief Patches the header count and closes; false if a write failed
+     */
+    bool close() {
+        if (file_ == nullptr) return true;
+        std::rewind(file_);
+        std::fwrite(&header_, sizeof(header_), 1, file_);
+        bool ok = !std::ferror(file_);
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        return ok;
+    }
+};
+
+/**
+ * @brief Writes ResultRecords to an SPR1 file
+ */
+class ResultFileWriter {
+private:
+    FILE* file_;
+    ResultFileHeader header_;
+
+    ResultFileWriter(const ResultFileWriter&);
+    ResultFileWriter& operator=(const ResultFileWriter&);
+
+public:
+    ResultFileWriter() : file_(nullptr) {}
+    ~ResultFileWriter() { close(); }
+
+    bool open(const std::string& path, int n, const std::string& algorithm, std::string& error) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            error = "cannot write " + path;
+            return false;
+        }
+        std::setvbuf(file_, nullptr, _IOFBF, size_t(1) << 20);
+        memset(&header_, 0, sizeof(header_));
+        memcpy(header_.magic, "SPR1", 4);
+        header_.version = 1;
+        header_.n = (uint32_t)n;
+        header_.record_bytes = sizeof(ResultRecord);
+        strncpy(header_.algorithm, algorithm.c_str(), sizeof(header_.algorithm) - 1);
+        std::fwrite(&header_, sizeof(header_), 1, file_);
+        return true;
+    }
+
+    void write(uint64_t puzzle_index, int solution_length, double execution_time_ms, uint64_t nodes_expanded) {
+        ResultRecord r;
+        r.puzzle_index = puzzle_index;
+        r.nodes_expanded = nodes_expanded;
+        r.execution_time_ms = execution_time_ms;
+        r.solution_length = solution_length;
+        r.reserved = 0;
+        std::fwrite(&r, sizeof(r), 1, file_);
+        header_.count++;
+    }
+
+    bool close() {
+        if (file_ == nullptr) return true;
+        std::rewind(file_);
+        std::fwrite(&header_, sizeof(header_), 1, file_);
+        bool ok = !std::ferror(file_);
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        return ok;
+    }
+};
+
+/**
+ * @brief Reads an SPR1 file record by record
+ */
+class ResultFileReader {
+private:
+    std::istream& in_;
+    ResultFileHeader header_;
+    uint64_t remaining_;
+    std::string error_;
+
+public:
+    explicit ResultFileReader(std::istream& in) : in_(in), remaining_(0) {
+        in_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+        if ((size_t)in_.gcount() != sizeof(header_) || memcmp(header_.magic, "SPR1", 4) != 0 ||
+            header_.version != 1 || header_.record_bytes != sizeof(ResultRecord)) {
+            error_ = "not an SPR1 result file";
+            return;
+        }
+        header_.algorithm[sizeof(header_.algorithm) - 1] = '\0';
+        remaining_ = header_.count;
+    }
+
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    int boardSize() const { return (int)header_.n; }
+    uint64_t count() const { return header_.count; }
+    std::string algorithm() const { return header_.algorithm; }
+
+    bool next(ResultRecord& r) {
+        if (remaining_ == 0) return false;
+        in_.read(reinterpret_cast<char*>(&r), sizeof(r));
+        if ((size_t)in_.gcount() != sizeof(r)) {
+            error_ = "truncated result file";
+            remaining_ = 0;
+            return false;
+        }
+        remaining_--;
+        return true;
+    }
+};
+
+} // namespace puzzle
+
+#endif // PUZZLE_IO_H
@@ -0,0 +1,314 @@
+/**
+ * @file puzzle_solver.cpp
+ * @brief One executable for every sequential solver, selected with --algo
+ *
+ * The algorithms live in bfs_search.h, astar_search.h and ida_search.h and
+ * are shared with the bsp/h1/h2/ida executables; solver_algorithms.h wraps
+ * each in a traits struct that puzzle_bench uses too. Each entry of ALGORITHMS
+ * points at runAlgorithm<...>, instantiated for that algorithm and every board
+ * size: the choice is made once, in main, and the search loop it reaches is
+ * compiled with its heuristic inlined and its board side fixed, as in the
+ * dedicated executables.
+ *
+ * --threads T solves T puzzles at a time, one solver per thread, through the
+ * streaming pipeline of batch_pipeline.h; rows still come out in input order.
+ * Output is the CSV of the *_nsize executables, so results are comparable.
+ *
+ * The PDB algorithms also look the diagonal mirror of each board up and keep
+ * the larger bound (see pattern_db.h); --no-mirror turns that off.
+ *
+ * --algo table answers 3x3 boards from the distance table of every solvable
+ * 3x3 board (eight_puzzle_table.h). --table FILE loads it, or builds it by
+ * one backward BFS and saves it there on first use; without --table it is
+ * built in memory (a few tens of milliseconds).
+ *
+ * --dedupe solves each distinct board once per run: repeats are answered from
+ * an in-memory SolutionCache. --cache FILE keeps that table in a mapped file
+ * instead, so it persists across runs and is shared by solver processes
+ * running at the same time (see solution_cache.h). A board and its mirror
+ * count as the same board. Answers from the cache are reported with 0 nodes
+ * expanded.
+ *
+ * Built with -DPUZZLE_PROFILE, --profile FILE writes per-thread call counts
+ * and times of the search phases (expand, heuristic, hash lookup/insert,
+ * open-list push/pop, allocation) as CSV, or JSON for a .json name.
+ *
+ * Compilation:
+ *      g++ -std=c++11 -O3 -pthread -o puzzle_solver puzzle_solver.cpp
+ *
+ * Usage example:
+ *      ./puzzle_solver puzzles.txt 4 --algo astar-h1
+ *      ./puzzle_solver puzzles.txt 4 --algo ida-pdb --pdb pdb_4x4.pdb --threads 8
+ *      ./puzzle_solver puzzles.txt 4 --algo ida --cache solutions_4x4.spc
+ *      ./puzzle_solver puzzles_3x3.txt 3 --algo table --table table_3x3.ept
+ *      ./puzzle_solver --list
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include "solver_algorithms.h"
+#include "batch_runner.h"
+#include "batch_pipeline.h"
+#include "solution_cache.h"
+#include "instrumentation.h"
+
+using namespace std;
+using namespace puzzle;
+
+struct SolverOptions : SolverConfig {
+    string puzzles_file;
+    int threads;
+    bool paths;
+    BatchFormat format;
+    SolutionCache* cache;         // --dedupe / --cache, nullptr otherwise
+};
+
+/**
+ * @brief Solves the batch with T solvers working on different puzzles
+ */
+template <typename Word, typename Algorithm>
+bool solveParallel(const SolverOptions& o, const char* label) {
+    typedef typename Algorithm::Solver Solver;
+    ChunkedLineReader reader(o.puzzles_file);
+    if (!reader.ok()) {
+        cerr << "Error: Cannot open file " << o.puzzles_file << endl;
+        return false;
+    }
+    vector<unique_ptr<Solver> > solvers;
+    vector<unique_ptr<ostringstream> > formatters;
+    for (int t = 0; t < o.threads; t++) {
+        solvers.emplace_back(Algorithm::create(o));
+        formatters.emplace_back(new ostringstream());
+    }
+
+    BufferedWriter out(stdout);
+    ostringstream header;
+    writeCsvHeader(header, o.paths);
+    out.write(header.str());
+
+    // Small chunks: a hard board holds back at most a few easy ones
+    StreamPipeline pipeline(o.threads, 16, 0, true);
+    pipeline.run(reader, out, [&](const PuzzleLine& line, int worker, string& rows) {
+        Solver& solver = *solvers[worker];
+        ostringstream& row = *formatters[worker];
+        PackedBoard<Word> board;
+        BoardResult r;
+        if (parseBoard(line.board, o.n, board)) {
+            solveBoard(solver, board, o.n, o.paths, o.cache, r);
+        } else {
+            cerr << "Error: Invalid " << o.n << "x" << o.n << " board '" << line.board << "'" << endl;
+        }
+        row.str(string());
+        writeCsvRow(row, line.index, line.board, r.solution_length, r.execution_time, r.nodes_expanded,
+                    label, o.paths ? &r.path : nullptr);
+        rows += row.str();
+    });
+    if (!out.close()) {
+        cerr << "Error: cannot write the results" << endl;
+        return false;
+    }
+    return true;
+}
+
+template <typename Word, typename Algorithm>
+bool solveWith(const SolverOptions& o, const char* label) {
+    if (o.threads > 1) return solveParallel<Word, Algorithm>(o, label);
+
+    ifstream file(o.puzzles_file, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error: Cannot open file " << o.puzzles_file << endl;
+        return false;
+    }
+    unique_ptr<typename Algorithm::Solver> solver(Algorithm::create(o));
+    return solveBatch<Word>(file, o.n, *solver, label, o.paths, o.format, NoPuzzleHook(), o.cache);
+}
+
+// dispatchBoardSize picks the instantiation of Algorithm for the board size
+template <template <typename, int> class Algorithm>
+struct AlgorithmRunner {
+    template <typename Word, int Side>
+    struct For {
+        static bool run(const SolverOptions& o, const char* label) {
+            return solveWith<Word, Algorithm<Word, Side> >(o, label);
+        }
+    };
+};
+
+template <template <typename, int> class Algorithm>
+bool runAlgorithm(const SolverOptions& o, const char* label) {
+    return dispatchBoardSize<AlgorithmRunner<Algorithm>::template For>(o.n, o, label);
+}
+
+struct AlgorithmEntry {
+    const char* name;    // --algo value
+    const char* label;   // algorithm column of the CSV
+    bool needs_pdb;
+    bool needs_table;    // 3x3 distance table (eight_puzzle_table.h)
+    bool (*run)(const SolverOptions&, const char*);
+    const char* description;
+};
+
+static const AlgorithmEntry ALGORITHMS[] = {
+    {"bfs",       "BFS",      false, false, runAlgorithm<BfsAlgorithm>,      "breadth-first search"},
+    {"bibfs",     "BiBFS",    false, false, runAlgorithm<BiBfsAlgorithm>,    "bidirectional BFS"},
+    {"astar-h1",  "A*-h1",    false, false, runAlgorithm<AStarH1Algorithm>,  "A* with Manhattan distance"},
+    {"astar-h2",  "A*-h2",    false, false, runAlgorithm<AStarH2Algorithm>,  "A* with misplaced tiles"},
+    {"astar-pdb", "A*-pdb",   true,  false, runAlgorithm<AStarPdbAlgorithm>, "A* with an additive pattern database"},
+    {"ida",       "IDA*-lc",  false, false, runAlgorithm<IdaAlgorithm>,      "IDA* with Manhattan + linear conflicts"},
+    {"ida-pdb",   "IDA*-pdb", true,  false, runAlgorithm<IdaPdbAlgorithm>,   "IDA* with linear conflicts and a pattern database"},
+    {"table",     "Table",    false, true,  runAlgorithm<TableAlgorithm>,    "3x3 only: lookup in the full state-space table"},
+};
+static const int NUM_ALGORITHMS = sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]);
+
+const AlgorithmEntry* findAlgorithm(const string& name) {
+    for (int i = 0; i < NUM_ALGORITHMS; i++) {
+        if (name == ALGORITHMS[i].name) return &ALGORITHMS[i];
+    }
+    return nullptr;
+}
+
+void listAlgorithms(ostream& out) {
+    for (int i = 0; i < NUM_ALGORITHMS; i++) {
+        out << "  " << ALGORITHMS[i].name << string(12 - string(ALGORITHMS[i].name).size(), ' ')
+            << ALGORITHMS[i].description << (ALGORITHMS[i].needs_pdb ? " (needs --pdb)" : "")
+            << (ALGORITHMS[i].needs_table ? " (--table <file>)" : "") << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    if (argc == 2 && string(argv[1]) == "--list") {
+        listAlgorithms(cout);
+        return 0;
+    }
+
+    SolverOptions options;
+    options.threads = 1;
+    options.paths = false;
+    options.pdb = nullptr;
+    options.mirror = true;
+    options.cache = nullptr;
+    string algo = "bfs";
+    string pdb_file;
+    string table_file;
+    string cache_file;
+    bool dedupe = false;
+    long long cache_slots = CACHE_DEFAULT_SLOTS;
+    string profile_file;
+    bool bad_args = argc < 3;
+    for (int i = 3; i < argc && !bad_args; i++) {
+        string arg = argv[i];
+        if (arg == "--algo" && i + 1 < argc) algo = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (arg == "--paths") options.paths = true;
+        else if (arg == "--pdb" && i + 1 < argc) pdb_file = argv[++i];
+        else if (arg == "--no-mirror") options.mirror = false;
+        else if (arg == "--table" && i + 1 < argc) table_file = argv[++i];
+        else if (arg == "--bin-in") options.format.binary_input = true;
+        else if (arg == "--bin-out" && i + 1 < argc) options.format.results_file = argv[++i];
+        else if (arg == "--dedupe") dedupe = true;
+        else if (arg == "--cache" && i + 1 < argc) cache_file = argv[++i];
+        else if (arg == "--cache-slots" && i + 1 < argc) cache_slots = atoll(argv[++i]);
+        else if (arg == "--profile" && i + 1 < argc) profile_file = argv[++i];
+        else bad_args = true;
+    }
+    bool binary = options.format.binary_input || !options.format.results_file.empty();
+    if (bad_args || options.threads < 1 || cache_slots < 1 || (binary && options.threads > 1) ||
+        (options.paths && !options.format.results_file.empty())) {
+        cerr << "Usage: " << argv[0] << " <puzzles_file> <N_size> [--algo <name>] [--threads <T>] [--paths]"
+             << " [--pdb <file.pdb> [--no-mirror]] [--table <file.ept>] [--bin-in] [--bin-out <results.spr>]\n"
+             << "       [--dedupe | --cache <file.spc>] [--cache-slots <count>] [--profile <phases.csv|.json>]\n"
+             << "       " << argv[0] << " --list\n"
+             << "Binary input/output is single-threaded. Algorithms:\n";
+        listAlgorithms(cerr);
+        return 1;
+    }
+
+    if (!profile_file.empty() && !PROFILE_ENABLED) {
+        cerr << "Error: --profile needs a build with -DPUZZLE_PROFILE" << endl;
+        return 1;
+    }
+
+    const AlgorithmEntry* entry = findAlgorithm(algo);
+    if (entry == nullptr) {
+        cerr << "Error: Unknown algorithm '" << algo << "'. Algorithms:\n";
+        listAlgorithms(cerr);
+        return 1;
+    }
+
+    options.puzzles_file = argv[1];
+    options.n = atoi(argv[2]);
+    if (!supportedBoardSize(options.n)) {
+        cerr << "Error: Unsupported board size " << options.n << " (supported: 2..5)" << endl;
+        return 1;
+    }
+
+    PatternDatabase pdb;
+    if (entry->needs_pdb) {
+        string error;
+        if (pdb_file.empty()) {
+            cerr << "Error: --algo " << entry->name << " needs --pdb <file.pdb>" << endl;
+            return 1;
+        }
+        if (!pdb.load(pdb_file, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if (pdb.boardSize() != options.n) {
+            cerr << "Error: " << pdb_file << " was built for N=" << pdb.boardSize() << endl;
+            return 1;
+        }
+        options.pdb = &pdb;
+    } else if (!pdb_file.empty()) {
+        cerr << "Error: --algo " << entry->name << " does not use a pattern database" << endl;
+        return 1;
+    }
+
+    EightPuzzleTable table;
+    if (entry->needs_table) {
+        string error;
+        if (options.n != 3) {
+            cerr << "Error: --algo " << entry->name << " solves 3x3 boards only" << endl;
+            return 1;
+        }
+        if (table_file.empty()) {
+            table.build();
+        } else if (!table.loadOrBuild(table_file, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        options.table = &table;
+    } else if (!table_file.empty()) {
+        cerr << "Error: --algo " << entry->name << " does not use the 3x3 table" << endl;
+        return 1;
+    }
+
+    SolutionCache cache;
+    if (dedupe || !cache_file.empty()) {
+        string error;
+        bool opened = cache_file.empty() ? cache.createInMemory(options.n, cache_slots, error)
+                                         : cache.open(cache_file, options.n, cache_slots, error);
+        if (!opened) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        options.cache = &cache;
+    }
+
+    bool ok = entry->run(options, entry->label);
+    if (options.cache != nullptr) {
+        CacheStats cs = cache.stats();
+        cerr << "cache hits=" << cs.hits << " misses=" << cs.misses << " stored=" << cs.stores
+             << " dropped=" << cs.dropped << " slots=" << cache.capacity() << endl;
+    }
+    if (!profile_file.empty() && !writeProfile(profile_file)) {
+        cerr << "Error: cannot write " << profile_file << endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
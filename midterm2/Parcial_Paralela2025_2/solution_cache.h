@@ -0,0 +1,330 @@
+/**
+ * @file solution_cache.h
+ * @brief Board -> optimal solution table, in memory or in a shared mapped file
+ *
+ * Every solver here returns optimal lengths, so a solved board has one answer
+ * whichever algorithm found it. SolutionCache keeps that length and the moves
+ * of the blank (2 bits per move) in a fixed-size open-addressing table keyed
+ * by the packed board; a repeated board costs one hash probe instead of a
+ * search. Boards are stored under canonicalBoard(), so a board and its
+ * diagonal mirror share one slot and a hit on the mirror is answered with the
+ * mirrored moves. Only solved boards are stored: parity already answers
+ * unsolvable ones, and a search that hit its limit may succeed with another
+ * algorithm.
+ *
+ * The table is one mapping: anonymous memory for a single run, or a file
+ * mapped MAP_SHARED so results persist across runs and processes solving at
+ * the same time see each other's results. A writer claims an empty slot with
+ * a compare-and-swap on its state word and publishes it with a release store,
+ * which works between processes sharing the mapping; nothing is locked while
+ * solving. Two processes finishing the same board at once may both store it,
+ * which only costs a slot. The file never grows: once the probe limit is
+ * reached, new results are not stored.
+ *
+ * File layout (host byte order):
+ *   CacheFileHeader
+ *   slot_count CacheSlot
+ */
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "puzzle_board.h"
+#include "move_tables.h"
+#include "node_arena.h"
+
+namespace puzzle {
+
+static const int CACHE_MAX_PATH = 256;              // moves stored per slot
+static const uint64_t CACHE_DEFAULT_SLOTS = 1 << 18;
+
+struct CacheFileHeader {
+    char magic[4];           // "SPC1"
+    uint32_t version;        // 1
+    uint32_t n;              // board side the keys were packed for
+    uint32_t slot_bytes;     // sizeof(CacheSlot)
+    uint64_t slot_count;     // power of two
+};
+
+struct CacheSlot {
+    uint32_t state;                        // SLOT_EMPTY, SLOT_WRITING or SLOT_READY
+    uint16_t length;                       // optimal number of moves
+    uint16_t reserved;
+    uint64_t key[2];                       // packed board, low and high 64 bits; path from this board
+    uint8_t moves[CACHE_MAX_PATH / 4];     // move i in bits 2*(i%4) of byte i/4
+};
+
+/**
+ * @brief Lookups and stores made through this process since it opened the cache
+ */
+struct CacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t dropped;   // results not stored: path too long or probe limit reached
+};
+
+inline void splitWord(uint64_t w, uint64_t* key) {
+    key[0] = w;
+    key[1] = 0;
+}
+
+inline void splitWord(uint128_t w, uint64_t* key) {
+    key[0] = static_cast<uint64_t>(w);
+    key[1] = static_cast<uint64_t>(w >> 64);
+}
+
+/**
+ * @brief Inverse of pathToString; false on an unknown move name
+ */
+inline bool parsePath(const std::string& path, std::vector<int>& moves) {
+    moves.clear();
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find(' ', start);
+        if (end == std::string::npos) end = path.size();
+        std::string name = path.substr(start, end - start);
+        int move = 0;
+        while (move < MOVE_NONE && name != moveName(move)) move++;
+        if (move == MOVE_NONE) return false;
+        moves.push_back(move);
+        start = end + 1;
+    }
+    return true;
+}
+
+class SolutionCache {
+private:
+    enum { SLOT_EMPTY = 0, SLOT_WRITING = 1, SLOT_READY = 2 };
+    static const int MAX_PROBE = 64;
+
+    void* map_;
+    size_t map_size_;
+    int n_;
+    CacheSlot* slots_;
+    uint64_t mask_;
+    std::atomic<uint64_t> hits_, misses_, stores_, dropped_;
+
+    SolutionCache(const SolutionCache&);
+    SolutionCache& operator=(const SolutionCache&);
+
+    void unmap() {
+        if (map_ != nullptr) munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+        slots_ = nullptr;
+    }
+
+    static size_t mapBytes(uint64_t slot_count) {
+        return sizeof(CacheFileHeader) + slot_count * sizeof(CacheSlot);
+    }
+
+    static uint64_t roundUpPow2(uint64_t n) {
+        uint64_t p = 16;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    void attach(void* map, size_t size, int n, uint64_t slot_count) {
+        map_ = map;
+        map_size_ = size;
+        n_ = n;
+        slots_ = reinterpret_cast<CacheSlot*>(static_cast<uint8_t*>(map) + sizeof(CacheFileHeader));
+        mask_ = slot_count - 1;
+    }
+
+    static uint32_t loadState(const CacheSlot& slot) {
+        return __atomic_load_n(&slot.state, __ATOMIC_ACQUIRE);
+    }
+
+public:
+    SolutionCache() : map_(nullptr), map_size_(0), n_(0), slots_(nullptr), mask_(0),
+                      hits_(0), misses_(0), stores_(0), dropped_(0) {}
+    ~SolutionCache() { unmap(); }
+
+    /**
+     * @brief Private table for this run, @p slot_count rounded up to a power of two
+     *
+     * The mapping is anonymous, so pages cost memory only once a slot on them
+     * is written.
+     */
+    bool createInMemory(int n, uint64_t slot_count, std::string& error) {
+        unmap();
+        slot_count = roundUpPow2(slot_count);
+        size_t size = mapBytes(slot_count);
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) {
+            error = "cannot allocate the solution cache";
+            return false;
+        }
+        attach(map, size, n, slot_count);
+        return true;
+    }
+
+    /**
+     * @brief Maps the cache file at @p path, creating it with @p slot_count slots if missing
+     *
+     * Creation and header checks run under an exclusive flock, so processes
+     * started together agree on one file. An existing file keeps its own slot
+     * count. On failure returns false and describes the problem in @p error.
+     */
+    bool open(const std::string& path, int n, uint64_t slot_count, std::string& error) {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            error = "cannot open " + path;
+            return false;
+        }
+        if (flock(fd, LOCK_EX) != 0) {
+            close(fd);
+            error = "cannot lock " + path;
+            return false;
+        }
+
+        CacheFileHeader header;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size == 0) {
+            memcpy(header.magic, "SPC1", 4);
+            header.version = 1;
+            header.n = static_cast<uint32_t>(n);
+            header.slot_bytes = sizeof(CacheSlot);
+            header.slot_count = roundUpPow2(slot_count);
+            ok = ftruncate(fd, static_cast<off_t>(mapBytes(header.slot_count))) == 0 &&
+                 pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+            if (!ok) error = "cannot create " + path;
+        } else if (ok) {
+            ok = st.st_size >= static_cast<off_t>(sizeof(header)) &&
+                 pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 memcmp(header.magic, "SPC1", 4) == 0 && header.version == 1 &&
+                 header.slot_bytes == sizeof(CacheSlot) && header.slot_count >= 16 &&
+                 (header.slot_count & (header.slot_count - 1)) == 0 &&
+                 st.st_size == static_cast<off_t>(mapBytes(header.slot_count));
+            if (!ok) {
+                error = path + " is not an SPC1 cache file";
+            } else if (header.n != static_cast<uint32_t>(n)) {
+                ok = false;
+                error = path + " caches " + std::to_string(header.n) + "x" + std::to_string(header.n) + " boards";
+            }
+        } else {
+            error = "cannot stat " + path;
+        }
+
+        void* map = MAP_FAILED;
+        if (ok) {
+            map = mmap(nullptr, mapBytes(header.slot_count), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                ok = false;
+                error = "cannot mmap " + path;
+            }
+        }
+        flock(fd, LOCK_UN);
+        close(fd);
+        if (!ok) return false;
+        attach(map, mapBytes(header.slot_count), n, header.slot_count);
+        return true;
+    }
+
+    bool ok() const { return slots_ != nullptr; }
+
+    /**
+     * @brief Solution length of @p board if cached; fills @p path when non-null
+     */
+    template <typename Word>
+    bool lookup(const PackedBoard<Word>& board, int& length, std::string* path) {
+        bool mirrored = false;
+        PackedBoard<Word> canonical = canonicalBoard(board, n_, mirrored);
+        uint64_t key[2];
+        splitWord(canonical.cells, key);
+        uint64_t home = hashWord(canonical.cells);
+        for (int probe = 0; probe < MAX_PROBE; probe++) {
+            const CacheSlot& slot = slots_[(home + probe) & mask_];
+            uint32_t state = loadState(slot);
+            if (state == SLOT_EMPTY) break;
+            if (state != SLOT_READY || slot.key[0] != key[0] || slot.key[1] != key[1]) continue;
+
+            length = slot.length;
+            if (path != nullptr) {
+                std::vector<int> moves(length);
+                for (int i = 0; i < length; i++) {
+                    int move = (slot.moves[i >> 2] >> ((i & 3) * 2)) & 3;
+                    moves[i] = mirrored ? mirrorMove(move) : move;
+                }
+                *path = pathToString(moves);
+            }
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Records the optimal @p length and @p path ("UP LEFT ...") of @p board
+     */
+    template <typename Word>
+    void store(const PackedBoard<Word>& board, int length, const std::string& path) {
+        std::vector<int> moves;
+        if (length < 0 || length > CACHE_MAX_PATH || !parsePath(path, moves) ||
+            static_cast<int>(moves.size()) != length) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        bool mirrored = false;
+        PackedBoard<Word> canonical = canonicalBoard(board, n_, mirrored);
+        if (mirrored) {
+            for (size_t i = 0; i < moves.size(); i++) moves[i] = mirrorMove(moves[i]);
+        }
+        uint64_t key[2];
+        splitWord(canonical.cells, key);
+        uint64_t home = hashWord(canonical.cells);
+        for (int probe = 0; probe < MAX_PROBE; probe++) {
+            CacheSlot& slot = slots_[(home + probe) & mask_];
+            uint32_t state = loadState(slot);
+            if (state == SLOT_READY && slot.key[0] == key[0] && slot.key[1] == key[1]) return;
+            if (state != SLOT_EMPTY) continue;
+
+            uint32_t expected = SLOT_EMPTY;
+            if (!__atomic_compare_exchange_n(&slot.state, &expected, static_cast<uint32_t>(SLOT_WRITING),
+                                             false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                continue;   // another writer took it
+            }
+            slot.key[0] = key[0];
+            slot.key[1] = key[1];
+            slot.length = static_cast<uint16_t>(length);
+            memset(slot.moves, 0, sizeof(slot.moves));
+            for (int i = 0; i < length; i++) slot.moves[i >> 2] |= static_cast<uint8_t>(moves[i] << ((i & 3) * 2));
+            __atomic_store_n(&slot.state, static_cast<uint32_t>(SLOT_READY), __ATOMIC_RELEASE);
+            stores_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int boardSize() const { return n_; }
+    uint64_t capacity() const { return slots_ != nullptr ? mask_ + 1 : 0; }
+
+    CacheStats stats() const {
+        CacheStats s;
+        s.hits = hits_.load(std::memory_order_relaxed);
+        s.misses = misses_.load(std::memory_order_relaxed);
+        s.stores = stores_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+} // namespace puzzle
+
+#endif // SOLUTION_CACHE_H
@@ -0,0 +1,102 @@
+/**
+ * @file solver_algorithms.h
+ * @brief The sequential algorithms as traits: solver type plus a factory
+ *
+ * Shared by puzzle_solver and puzzle_bench, so both build exactly the same
+ * solvers. Each traits template takes the word layout and the board side
+ * (0 = runtime side, see BoardDim), which is what dispatchBoardSize expects.
+ */
+#ifndef SOLVER_ALGORITHMS_H
+#define SOLVER_ALGORITHMS_H
+
+#include "bfs_search.h"
+#include "astar_search.h"
+#include "ida_search.h"
+#include "pattern_db.h"
+#include "eight_puzzle_table.h"
+
+namespace puzzle {
+
+/**
+ * @brief What the factories need: board side and, for the PDB algorithms, the database
+ */
+struct SolverConfig {
+    int n;
+    const PatternDatabase* pdb;   // loaded when the algorithm needs one
+    bool mirror;                  // PDB lookups on the board and its mirror
+    const EightPuzzleTable* table;   // built or loaded for the 3x3 table algorithm
+
+    SolverConfig() : n(0), pdb(nullptr), mirror(true), table(nullptr) {}
+};
+
+// One traits struct per algorithm: the solver type and how to build one,
+// for a word layout and a board side (0 = runtime side, see BoardDim)
+
+template <typename Word, int Side>
+struct BfsAlgorithm {
+    typedef BFS_NSize<Word, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n); }
+};
+
+template <typename Word, int Side>
+struct BiBfsAlgorithm {
+    typedef BiBFS_NSize<Word, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n); }
+};
+
+template <typename Word, int Side>
+struct AStarH1Algorithm {
+    typedef ManhattanHeuristic<Word, Side> Heuristic;
+    typedef AStar_NSize<Word, Heuristic, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n, Heuristic(o.n)); }
+};
+
+template <typename Word, int Side>
+struct AStarH2Algorithm {
+    typedef MisplacedTilesHeuristic<Word, Side> Heuristic;
+    typedef AStar_NSize<Word, Heuristic, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n, Heuristic(o.n)); }
+};
+
+template <typename Word, int Side>
+struct AStarPdbAlgorithm {
+    typedef AStar_NSize<Word, PdbHeuristic<Word>, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n, PdbHeuristic<Word>(*o.pdb, o.n, o.mirror)); }
+};
+
+template <typename Word, int Side>
+struct IdaAlgorithm {
+    typedef IDAStar_LC<Word, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n, nullptr); }
+};
+
+// IDAStar_LC only points at its PDB heuristic; this solver owns it
+template <typename Word>
+struct OwnedPdbHeuristic {
+    PdbHeuristic<Word> pdb_heuristic;
+    OwnedPdbHeuristic(const PatternDatabase& db, int n, bool mirror) : pdb_heuristic(db, n, mirror) {}
+};
+
+template <typename Word, int Side>
+class IDAStarPdb : private OwnedPdbHeuristic<Word>, public IDAStar_LC<Word, Side> {
+public:
+    IDAStarPdb(int n, const PatternDatabase& db, bool mirror)
+        : OwnedPdbHeuristic<Word>(db, n, mirror), IDAStar_LC<Word, Side>(n, &this->pdb_heuristic) {}
+};
+
+template <typename Word, int Side>
+struct IdaPdbAlgorithm {
+    typedef IDAStarPdb<Word, Side> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.n, *o.pdb, o.mirror); }
+};
+
+// 3x3 only: callers check the board size and fill SolverConfig::table
+template <typename Word, int Side>
+struct TableAlgorithm {
+    typedef EightTableSolver<Word> Solver;
+    static Solver* create(const SolverConfig& o) { return new Solver(o.table); }
+};
+
+} // namespace puzzle
+
+#endif // SOLVER_ALGORITHMS_H
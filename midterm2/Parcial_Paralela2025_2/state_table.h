@@ -0,0 +1,374 @@
+/**
+ * @file state_table.h
+ * @brief Flat open-addressing hash table keyed by packed boards
+ *
+ * Replaces std::set<std::string> / std::unordered_set<std::string> as the
+ * visited/closed structure of the solvers. Slots live in one contiguous
+ * array sized up front from the solver's state limit, collisions are resolved
+ * by linear probing, and nothing is allocated per insert.
+ *
+ * The all-zero word is used as the empty-slot marker: it would be a board made
+ * only of blanks, which parseBoard never produces.
+ *
+ * StateTable<Word> is a set; StateTable<Word, Value> additionally stores one
+ * Value per key (e.g. the best g seen for a state).
+ *
+ * ConcurrentStateSet is the insert-only variant several threads can fill at
+ * the same time (64-bit keys, i.e. boards up to 4x4).
+ *
+ * RankedStateSet is a drop-in set for 3x3 boards: one bit per solvable board,
+ * addressed by its perfect hash, so there is no hashing or probing at all.
+ */
+#ifndef STATE_TABLE_H
+#define STATE_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "puzzle_board.h"
+#include "permutation_rank.h"
+
+namespace puzzle {
+
+struct NoValue {};
+
+template <typename Word, typename Value>
+struct TableSlot {
+    Word key;
+    Value value;
+};
+
+// Sets store bare keys; the shared static keeps slot.value usable in the table
+template <typename Word>
+struct TableSlot<Word, NoValue> {
+    Word key;
+    static NoValue value;
+};
+
+template <typename Word>
+NoValue TableSlot<Word, NoValue>::value;
+
+/**
+ * @brief Probe statistics accumulated since the last clear()
+ */
+struct TableStats {
+    size_t size;
+    size_t capacity;
+    size_t operations;   // finds + inserts
+    size_t probes;       // slots examined by those operations
+    size_t max_probe;    // longest single probe sequence
+
+    double loadFactor() const { return capacity ? (double)size / capacity : 0.0; }
+    double averageProbe() const { return operations ? (double)probes / operations : 0.0; }
+};
+
+template <typename Word, typename Value = NoValue>
+class StateTable {
+private:
+    typedef TableSlot<Word, Value> Slot;
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> used_;   // occupied slot indices, so clear() is O(size)
+    size_t mask_;
+    size_t operations_;
+    size_t probes_;
+    size_t max_probe_;
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 16;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Returns the slot holding `key`, or the empty slot where it belongs
+    size_t locate(Word key) {
+        size_t i = static_cast<size_t>(hashWord(key)) & mask_;
+        size_t probe = 1;
+        while (slots_[i].key != 0 && slots_[i].key != key) {
+            i = (i + 1) & mask_;
+            probe++;
+        }
+        operations_++;
+        probes_ += probe;
+        if (probe > max_probe_) max_probe_ = probe;
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        std::vector<uint32_t> old_used;
+        old_used.swap(used_);
+
+        slots_.assign(old.size() * 2, Slot());
+        mask_ = slots_.size() - 1;
+        used_.reserve(old_used.capacity() * 2);
+        for (size_t k = 0; k < old_used.size(); k++) {
+            const Slot& s = old[old_used[k]];
+            size_t i = static_cast<size_t>(hashWord(s.key)) & mask_;
+            while (slots_[i].key != 0) i = (i + 1) & mask_;
+            slots_[i] = s;
+            used_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+public:
+    /**
+     * @brief Preallocates room for @p max_entries keys at a load factor <= 0.5
+     */
+    explicit StateTable(size_t max_entries)
+        : operations_(0), probes_(0), max_probe_(0) {
+        slots_.assign(roundUpPow2(max_entries * 2), Slot());
+        mask_ = slots_.size() - 1;
+        used_.reserve(max_entries);
+    }
+
+    /**
+     * @brief Inserts @p key; returns false if it was already present
+     */
+    bool insert(Word key) {
+        return insert(key, Value());
+    }
+
+    bool insert(Word key, const Value& value) {
+        size_t i = locate(key);
+        if (slots_[i].key == key) return false;
+        slots_[i].key = key;
+        slots_[i].value = value;
+        used_.push_back(static_cast<uint32_t>(i));
+        if (used_.size() * 4 > slots_.size() * 3) grow();
+        return true;
+    }
+
+    /**
+     * @brief The value stored for @p key, inserting @p value first if the key is absent
+     *
+     * @p inserted tells which of the two happened; one probe sequence either
+     * way. The pointer is invalidated by the next insert.
+     */
+    Value* insertOrFind(Word key, const Value& value, bool& inserted) {
+        size_t i = locate(key);
+        inserted = slots_[i].key != key;
+        if (!inserted) return &slots_[i].value;
+        slots_[i].key = key;
+        slots_[i].value = value;
+        used_.push_back(static_cast<uint32_t>(i));
+        if (used_.size() * 4 <= slots_.size() * 3) return &slots_[i].value;
+        grow();
+        return find(key);
+    }
+
+    bool contains(Word key) {
+        return slots_[locate(key)].key == key;
+    }
+
+    /**
+     * @brief Pointer to the value stored for @p key, or nullptr if absent
+     *
+     * The pointer is invalidated by the next insert.
+     */
+    Value* find(Word key) {
+        size_t i = locate(key);
+        return slots_[i].key == key ? &slots_[i].value : nullptr;
+    }
+
+    size_t size() const { return used_.size(); }
+    size_t capacity() const { return slots_.size(); }
+
+    /**
+     * @brief Empties the table and resets statistics, keeping its capacity
+     */
+    void clear() {
+        for (size_t k = 0; k < used_.size(); k++) {
+            slots_[used_[k]] = Slot();
+        }
+        used_.clear();
+        operations_ = probes_ = max_probe_ = 0;
+    }
+
+    TableStats stats() const {
+        TableStats s;
+        s.size = size();
+        s.capacity = capacity();
+        s.operations = operations_;
+        s.probes = probes_;
+        s.max_probe = max_probe_;
+        return s;
+    }
+};
+
+/**
+ * @brief Insert-only set of 64-bit keys filled concurrently by several threads
+ *
+ * Same layout as StateTable (power-of-two slots, linear probing, 0 = empty),
+ * but every slot is an std::atomic<uint64_t> and insert() claims an empty slot
+ * with a compare-and-swap, so when several threads insert the same key exactly
+ * one of them gets true. Keys are never removed during a search.
+ *
+ * The table does not grow on its own and has no shared size counter (callers
+ * already know how many inserts succeeded): reserve() and clear() must be
+ * called by a single thread between parallel phases.
+ */
+class ConcurrentStateSet {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    size_t capacity_;
+    size_t mask_;
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 16;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    void allocate(size_t capacity) {
+        slots_.reset(new std::atomic<uint64_t>[capacity]);
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        for (size_t i = 0; i < capacity_; i++) slots_[i].store(0, std::memory_order_relaxed);
+    }
+
+    size_t home(uint64_t key) const {
+        return static_cast<size_t>(hashWord(key)) & mask_;
+    }
+
+public:
+    /**
+     * @brief Preallocates room for @p max_entries keys at a load factor <= 0.5
+     */
+    explicit ConcurrentStateSet(size_t max_entries) {
+        allocate(roundUpPow2(max_entries * 2));
+    }
+
+    /**
+     * @brief Inserts @p key; returns false if it was already present
+     *
+     * Safe to call from any number of threads at once. The table must have a
+     * free slot (see reserve()).
+     */
+    bool insert(uint64_t key) {
+        size_t i = home(key);
+        while (true) {
+            uint64_t current = slots_[i].load(std::memory_order_relaxed);
+            if (current == key) return false;
+            if (current == 0) {
+                if (slots_[i].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                    return true;
+                }
+                if (current == key) return false;   // lost the race to the same key
+            }
+            i = (i + 1) & mask_;
+        }
+    }
+
+    bool contains(uint64_t key) const {
+        size_t i = home(key);
+        while (true) {
+            uint64_t current = slots_[i].load(std::memory_order_relaxed);
+            if (current == key) return true;
+            if (current == 0) return false;
+            i = (i + 1) & mask_;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Grows and rehashes so @p entries keys fit at load <= 0.5
+     */
+    void reserve(size_t entries) {
+        if (entries * 2 <= capacity_) return;
+        std::unique_ptr<std::atomic<uint64_t>[]> old(slots_.release());
+        size_t old_capacity = capacity_;
+        allocate(roundUpPow2(entries * 2));
+        for (size_t k = 0; k < old_capacity; k++) {
+            uint64_t key = old[k].load(std::memory_order_relaxed);
+            if (key != 0) insert(key);
+        }
+    }
+
+    /**
+     * @brief Empties the table given the @p count keys it holds, key_at(i) -> key
+     *
+     * Every key sits in the run of occupied slots that starts at its home slot,
+     * so zeroing that run for each key empties the table in O(count) instead of
+     * sweeping every slot. Large tables fall back to the sweep.
+     */
+    template <typename KeyAt>
+    void clear(size_t count, KeyAt key_at) {
+        if (count * 4 > capacity_) {
+            for (size_t i = 0; i < capacity_; i++) slots_[i].store(0, std::memory_order_relaxed);
+            return;
+        }
+        for (size_t k = 0; k < count; k++) {
+            size_t i = home(key_at(k));
+            while (slots_[i].load(std::memory_order_relaxed) != 0) {
+                slots_[i].store(0, std::memory_order_relaxed);
+                i = (i + 1) & mask_;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Set of 3x3 boards as a bitset over rankEightPuzzle, same interface as StateTable
+ *
+ * 181,440 bits (22 KB) cover the whole 3x3 state space, where a StateTable
+ * sized for a solver's state limit takes megabytes. Every operation is one
+ * rank and one bit test, reported as a single probe in stats().
+ */
+template <typename Word>
+class RankedStateSet {
+private:
+    std::vector<uint64_t> bits_;
+    size_t size_;
+    size_t operations_;
+
+public:
+    // The space is fixed, so the solver's size hint is not needed
+    explicit RankedStateSet(size_t = 0)
+        : bits_((EIGHT_PUZZLE_STATES + 63) / 64, 0), size_(0), operations_(0) {}
+
+    bool insert(Word key) {
+        uint32_t index = rankEightPuzzle(key);
+        uint64_t bit = uint64_t(1) << (index & 63);
+        uint64_t& word = bits_[index >> 6];
+        operations_++;
+        if (word & bit) return false;
+        word |= bit;
+        size_++;
+        return true;
+    }
+
+    bool contains(Word key) {
+        uint32_t index = rankEightPuzzle(key);
+        operations_++;
+        return (bits_[index >> 6] >> (index & 63)) & 1;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return EIGHT_PUZZLE_STATES; }
+
+    void clear() {
+        std::fill(bits_.begin(), bits_.end(), 0);
+        size_ = operations_ = 0;
+    }
+
+    TableStats stats() const {
+        TableStats s;
+        s.size = size_;
+        s.capacity = capacity();
+        s.operations = operations_;
+        s.probes = operations_;
+        s.max_probe = operations_ ? 1 : 0;
+        return s;
+    }
+};
+
+} // namespace puzzle
+
+#endif // STATE_TABLE_H
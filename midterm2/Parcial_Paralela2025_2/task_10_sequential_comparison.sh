@@ -30,11 +30,12 @@ run_algorithm() {
     local algorithm_name="$1"
     local executable="$2"
     local output_file="$3"
+    local extra_args="$4"
     
     echo "🔄 Ejecutando $algorithm_name con 42 puzzles..."
     
     start_time=$(date +%s.%N)
-    ./$executable puzzles.txt 4 > "$output_file"
+    ./$executable puzzles.txt 4 $extra_args > "$output_file"
     end_time=$(date +%s.%N)
     
     # Calcular tiempo total usando aritmética de shell
@@ -59,6 +60,7 @@ echo ""
 
 # Ejecutar cada algoritmo
 run_algorithm "BFS" "bsp_solver_metrics" "results/sequential_analysis/BFS_results.csv"
+run_algorithm "BiBFS" "bsp_solver_metrics" "results/sequential_analysis/BiBFS_results.csv" "--bidirectional"
 run_algorithm "A*-h1" "h1_solver_metrics" "results/sequential_analysis/H1_results.csv"  
 run_algorithm "A*-h2" "h2_solver_metrics" "results/sequential_analysis/H2_results.csv"
 
@@ -101,6 +103,7 @@ calculate_stats() {
 
 # Generar estadísticas para cada algoritmo
 calculate_stats "results/sequential_analysis/BFS_results.csv" "BFS"
+calculate_stats "results/sequential_analysis/BiBFS_results.csv" "BiBFS"
 calculate_stats "results/sequential_analysis/H1_results.csv" "A*-h1"
 calculate_stats "results/sequential_analysis/H2_results.csv" "A*-h2"
 
@@ -154,6 +157,7 @@ analyze_by_complexity() {
 }
 
 analyze_by_complexity "results/sequential_analysis/BFS_results.csv" "BFS"
+analyze_by_complexity "results/sequential_analysis/BiBFS_results.csv" "BiBFS"
 analyze_by_complexity "results/sequential_analysis/H1_results.csv" "A*-h1"
 analyze_by_complexity "results/sequential_analysis/H2_results.csv" "A*-h2"
 
@@ -184,6 +188,7 @@ echo "========================================================"
 echo ""
 echo "✅ Archivos generados:"
 echo "   📄 BFS_results.csv - Resultados detallados BFS"
+echo "   📄 BiBFS_results.csv - Resultados detallados BFS bidireccional"
 echo "   📄 H1_results.csv - Resultados detallados A*-h1"  
 echo "   📄 H2_results.csv - Resultados detallados A*-h2"
 echo "   📄 comparative_summary.csv - Resumen comparativo"
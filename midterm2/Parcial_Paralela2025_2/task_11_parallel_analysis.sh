@@ -168,6 +168,53 @@ for threads in "${thread_configs[@]}"; do
     fi
 done
 
+echo "🧵 Ejecutando BFS paralelo por niveles (--intra-bfs)..."
+
+# Cada capa del BFS se expande con todos los hilos; los puzzles van uno a uno
+cat > results/parallel_analysis/intra_bfs_metrics.csv << EOF
+Threads,Sequential_Time_ms,Parallel_Time_ms,Speedup,Sequential_Nodes,Parallel_Nodes
+EOF
+
+for threads in "${thread_configs[@]}"; do
+    echo "   BFS por niveles con $threads hilo(s)..."
+    ./bsp_parallel puzzles.txt $threads --intra-bfs > "results/parallel_analysis/intra_bfs_${threads}threads_summary.txt"
+    if [ -f "parallel_results_fixed.csv" ]; then
+        mv parallel_results_fixed.csv "results/parallel_analysis/intra_bfs_${threads}threads.csv"
+    fi
+    awk -v t="$threads" -F': ' '
+        /Sequential wall time/ {seq=$2} /Parallel wall time/ {par=$2} /Speedup/ {sp=$2}
+        /Sequential total nodes/ {sn=$2} /Parallel total nodes/ {pn=$2}
+        END {gsub(/[ x]/, "", sp); gsub(/ /, "", seq); gsub(/ /, "", par); gsub(/ /, "", pn);
+             printf "%s,%s,%s,%s,%s,%s\n", t, seq, par, sp, sn, pn}' \
+        "results/parallel_analysis/intra_bfs_${threads}threads_summary.txt" >> results/parallel_analysis/intra_bfs_metrics.csv
+done
+echo ""
+
+echo "🧵 Ejecutando A* paralelo intra-puzzle (HDA*)..."
+
+# HDA*: todos los hilos cooperan en cada puzzle; los estados se reparten por hash
+g++ -std=c++17 -fopenmp -O2 hda_parallel_solver.cpp -o hda_parallel
+
+cat > results/parallel_analysis/hda_metrics.csv << EOF
+Threads,Sequential_Time_ms,Parallel_Time_ms,Speedup,Total_Nodes,Search_Overhead,States_Sent,Mismatches
+EOF
+
+for threads in "${thread_configs[@]}"; do
+    echo "   HDA* con $threads hilo(s)..."
+    ./hda_parallel puzzles.txt $threads > "results/parallel_analysis/hda_${threads}threads_summary.txt"
+    if [ -f "hda_results.csv" ]; then
+        mv hda_results.csv "results/parallel_analysis/hda_${threads}threads.csv"
+    fi
+    awk -v t="$threads" -F': ' '
+        /Sequential wall time/ {seq=$2} /Parallel wall time/ {par=$2}
+        /Speedup/ {sp=$2} /Parallel total nodes/ {nodes=$2} /Search overhead/ {ov=$2}
+        /States sent/ {sent=$2} /mismatches/ {mm=$2}
+        END {gsub(/[ x]/, "", sp); gsub(/[ x]/, "", ov); gsub(/ /, "", seq); gsub(/ /, "", par); gsub(/ /, "", nodes);
+             printf "%s,%s,%s,%s,%s,%s,%s,%s\n", t, seq, par, sp, nodes, ov, sent, mm}' \
+        "results/parallel_analysis/hda_${threads}threads_summary.txt" >> results/parallel_analysis/hda_metrics.csv
+done
+echo ""
+
 echo "📈 Generando resumen de hallazgos de paralelización..."
 
 # Crear archivo de análisis detallado
@@ -177,7 +224,9 @@ ANÁLISIS DE PARALELIZACIÓN CON OPENMP
 1. ESTRATEGIA IMPLEMENTADA:
    - Descomposición de dominio (data decomposition)
    - Cada hilo procesa un subconjunto de puzzles independiente
-   - Scheduling dinámico para balanceo automático de carga
+   - Work stealing: los puzzles se ordenan por distancia Manhattan (más
+     difíciles primero) y se reparten en un deque por hilo; un hilo sin
+     trabajo roba los puzzles más fáciles pendientes de otro hilo
 
 2. JUSTIFICACIÓN DE LA ESTRATEGIA:
    - Los puzzles son independientes entre sí
@@ -186,8 +235,11 @@ ANÁLISIS DE PARALELIZACIÓN CON OPENMP
    - Escalable hasta el número de puzzles disponibles
 
 3. IMPLEMENTACIÓN TÉCNICA:
-   #pragma omp parallel for schedule(dynamic) shared(puzzles, results)
-   - schedule(dynamic): Balanceo automático de carga
+   #pragma omp parallel + puzzle::WorkStealingScheduler (work_stealing.h)
+   - Deque Chase-Lev por hilo: el dueño toma el puzzle más difícil, los
+     ladrones el más fácil
+   - Se reportan robos, tiempo ocioso por hilo y latencia de cola (desde que
+     el primer hilo queda sin trabajo hasta el fin del lote)
    - omp_get_wtime(): Medición precisa de tiempo
    - Variables compartidas para datos y resultados
 
@@ -233,6 +285,18 @@ else
 fi
 echo ""
 
+echo "=== BFS PARALELO POR NIVELES ==="
+if [ -f results/parallel_analysis/intra_bfs_metrics.csv ]; then
+    awk -F',' '{printf "%-8s %-20s %-18s %-8s %-18s %-16s\n", $1, $2, $3, $4, $5, $6}' results/parallel_analysis/intra_bfs_metrics.csv
+fi
+echo ""
+
+echo "=== A* PARALELO INTRA-PUZZLE (HDA*) ==="
+if [ -f results/parallel_analysis/hda_metrics.csv ]; then
+    awk -F',' '{printf "%-8s %-20s %-18s %-8s %-12s %-16s %-12s %-10s\n", $1, $2, $3, $4, $5, $6, $7, $8}' results/parallel_analysis/hda_metrics.csv
+fi
+echo ""
+
 echo "=== DISTRIBUCIÓN DE TRABAJO ==="
 if [ -f results/parallel_analysis/thread_distribution.csv ]; then
     echo "Primeras 10 líneas del análisis de distribución:"
@@ -253,6 +317,8 @@ echo "   📄 speedup_analysis.csv - Análisis de speedup y eficiencia"
 echo "   📄 thread_distribution.csv - Distribución de trabajo por hilo"
 echo "   📄 parallelization_findings.txt - Análisis detallado"
 echo "   📄 parallel_Nthreads.csv - Resultados detallados por configuración"
+echo "   📄 intra_bfs_metrics.csv - BFS paralelo por niveles (--intra-bfs) por número de hilos"
+echo "   📄 hda_metrics.csv - A* paralelo intra-puzzle (HDA*) por número de hilos"
 echo ""
 echo "🎯 Métricas obligatorias calculadas:"
 echo "   ✅ Tiempo de ejecución (segundos/milisegundos)"
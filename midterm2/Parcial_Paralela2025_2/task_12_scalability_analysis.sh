@@ -21,6 +21,7 @@ echo "📦 Compilando algoritmos con soporte para tamaño N..."
 g++ -std=c++11 -O2 bsp_solver_nsize.cpp -o bsp_nsize
 g++ -std=c++11 -O2 h1_solver_nsize.cpp -o h1_nsize
 g++ -std=c++11 -O2 h2_solver_nsize.cpp -o h2_nsize
+g++ -std=c++11 -O2 ida_solver_nsize.cpp -o ida_nsize
 
 echo "✅ Compilación completada"
 echo ""
@@ -37,10 +38,11 @@ ABCD#EFGH
 ABC#DEFGH
 EOF
 
-# Puzzles 5x5 (SOLUCIONABLES - estado muy cercano al objetivo)
+# Puzzles 5x5 (SOLUCIONABLES - validados por paridad; 1, 20 y 38 movimientos)
 cat > puzzles_5x5.txt << EOF
-ABCDEFGHJ#IKLMNOPQRSTUVWX
-ABCDEFGHIJKLMNOPQRSTUV#XY
+ABCDEFGHIJKLMNOPQRSTUVW#X
+ABDJIFHMCEKGQNOPLWRT#UVSX
+ABDEJKCHIOLFMSNGRT#XUQPVW
 EOF
 
 echo "✅ Puzzles de prueba generados"
@@ -63,7 +65,7 @@ Algorithm,Board_Size,Puzzle_Index,Solution_Length,Execution_Time_ms,Nodes_Expand
 EOF
     
     # Probar cada algoritmo
-    for algo in "BFS:bsp_nsize" "A*-h1:h1_nsize" "A*-h2:h2_nsize"; do
+    for algo in "BFS:bsp_nsize" "A*-h1:h1_nsize" "A*-h2:h2_nsize" "IDA*-lc:ida_nsize"; do
         IFS=':' read -r algo_name executable <<< "$algo"
         
         echo "   🔄 Ejecutando $algo_name en ${size}x${size}..."
@@ -119,7 +121,7 @@ echo "==================== TAMAÑO 4x4 ===================="
 analyze_scalability "4" "puzzles.txt" "10"  # Solo primeros 10 para comparación
 
 echo "==================== TAMAÑO 5x5 ===================="
-analyze_scalability "5" "puzzles_5x5.txt" "2"  # Solo 2 puzzles para demostrar escalabilidad
+analyze_scalability "5" "puzzles_5x5.txt" "3"  # Solo 3 puzzles para demostrar escalabilidad
 
 echo "📊 Generando resumen de escalabilidad..."
 
@@ -134,7 +136,7 @@ calculate_scalability_stats() {
     local file="results/scalability_analysis/scalability_${size}x${size}.csv"
     
     if [ -f "$file" ]; then
-        for algo in "BFS" "A*-h1" "A*-h2"; do
+        for algo in "BFS" "A*-h1" "A*-h2" "IDA*-lc"; do
             # Filtrar por algoritmo (columna 8 contiene el algoritmo)
             awk -F',' '$8 == "'$algo'"' "$file" > temp_algo.csv 2>/dev/null
             
@@ -0,0 +1,129 @@
+#!/bin/bash
+
+# ============================================================================
+# TAREA 13: HEURÍSTICA DE BASES DE DATOS DE PATRONES (PDB ADITIVA)
+# ============================================================================
+# Este script construye la PDB aditiva disjunta 6-6-3 para tableros 4x4,
+# mide el tiempo de construcción y compara los nodos expandidos contra la
+# distancia Manhattan (A*-h1 e IDA*-lc) sobre el dataset de 42 puzzles.
+# Además verifica que A* con PDB siga siendo óptimo: la PDB es admisible pero
+# no consistente, así que sus longitudes en 3x3 se comparan con la tabla
+# completa del espacio de estados
+# ============================================================================
+
+echo "========================================================"
+echo "    TAREA 13: ANÁLISIS DE PATTERN DATABASES (PDB)"
+echo "========================================================"
+echo ""
+
+# Crear directorio para resultados
+mkdir -p results/pdb_analysis
+
+echo "📦 Compilando constructor de PDB y solvers..."
+
+g++ -std=c++11 -O2 pdb_builder.cpp -o pdb_builder
+g++ -std=c++11 -O2 h1_solver_nsize.cpp -o h1_nsize
+g++ -std=c++11 -O2 ida_solver_nsize.cpp -o ida_nsize
+g++ -std=c++11 -O2 puzzle_gen.cpp -o puzzle_gen
+g++ -std=c++11 -O2 -pthread puzzle_solver.cpp -o puzzle_solver
+
+echo "✅ Compilación completada"
+echo ""
+
+# Construir la PDB (benchmark de construcción)
+echo "🏗️  Construyendo PDB 6-6-3 para 4x4 (puede tardar alrededor de un minuto)..."
+start_time=$(date +%s.%N)
+./pdb_builder 4 pdb_4x4.pdb > results/pdb_analysis/build_benchmark.txt
+end_time=$(date +%s.%N)
+build_time=$(awk "BEGIN {printf \"%.3f\", $end_time - $start_time}")
+echo "Total_wall_time_s: $build_time" >> results/pdb_analysis/build_benchmark.txt
+
+sed 's/^/   /' results/pdb_analysis/build_benchmark.txt
+echo ""
+
+# Ejecutar cada solver con Manhattan y con PDB
+echo "🔄 Ejecutando A* e IDA* con y sin PDB..."
+./h1_nsize puzzles.txt 4 > results/pdb_analysis/H1_manhattan.csv
+./h1_nsize puzzles.txt 4 --pdb pdb_4x4.pdb > results/pdb_analysis/H1_pdb.csv
+./ida_nsize puzzles.txt 4 > results/pdb_analysis/IDA_lc.csv
+./ida_nsize puzzles.txt 4 --pdb pdb_4x4.pdb > results/pdb_analysis/IDA_pdb.csv
+echo "✅ Ejecuciones completadas"
+echo ""
+
+echo "📊 Calculando reducción de nodos expandidos..."
+
+echo "Baseline,Variant,Puzzle_Index,Board,Solution_Length,Nodes_Baseline,Nodes_PDB,Reduction_%" \
+    > results/pdb_analysis/node_reduction.csv
+echo "Baseline,Variant,Puzzles,Total_Nodes_Baseline,Total_Nodes_PDB,Reduction_%,Time_Baseline_ms,Time_PDB_ms" \
+    > results/pdb_analysis/node_reduction_summary.csv
+
+# Une por índice de puzzle los resultados base y con PDB
+# (columnas: 1-7 del archivo base, 8-14 del archivo con PDB)
+compare_runs() {
+    local baseline_file="$1"
+    local variant_file="$2"
+
+    paste -d',' <(tail -n +2 "$baseline_file" | tr -d '\r') <(tail -n +2 "$variant_file" | tr -d '\r') > temp_joined.csv
+
+    awk -F',' '{
+        reduction = ($5 > 0) ? (1 - $12 / $5) * 100 : 0
+        printf "%s,%s,%s,%s,%s,%s,%s,%.2f\n", $7, $14, $1, $2, $3, $5, $12, reduction
+    }' temp_joined.csv >> results/pdb_analysis/node_reduction.csv
+
+    awk -F',' '{
+        base = $7; variant = $14; count++
+        nodes_base += $5; nodes_pdb += $12; time_base += $4; time_pdb += $11
+    } END {
+        reduction = (nodes_base > 0) ? (1 - nodes_pdb / nodes_base) * 100 : 0
+        printf "%s,%s,%d,%d,%d,%.2f,%.3f,%.3f\n", base, variant, count, nodes_base, nodes_pdb, reduction, time_base, time_pdb
+    }' temp_joined.csv >> results/pdb_analysis/node_reduction_summary.csv
+
+    rm -f temp_joined.csv
+}
+
+compare_runs results/pdb_analysis/H1_manhattan.csv results/pdb_analysis/H1_pdb.csv
+compare_runs results/pdb_analysis/IDA_lc.csv results/pdb_analysis/IDA_pdb.csv
+
+echo "📋 Resumen de reducción de nodos:"
+echo ""
+awk -F',' '{printf "%-10s %-10s %-8s %-20s %-16s %-12s %-16s %-12s\n", $1, $2, $3, $4, $5, $6, $7, $8}' \
+    results/pdb_analysis/node_reduction_summary.csv
+echo ""
+
+# Regresión: A*-pdb debe dar la longitud óptima (la de la tabla 3x3) en cada tablero
+echo "🔍 Verificando optimalidad de A*-pdb contra la tabla 3x3..."
+./pdb_builder 3 pdb_3x3.pdb > /dev/null
+./puzzle_gen 3 3000 --random --seed 5 --txt results/pdb_analysis/random_3x3.txt 2> /dev/null
+./puzzle_solver results/pdb_analysis/random_3x3.txt 3 --algo table > temp_table.csv
+./puzzle_solver results/pdb_analysis/random_3x3.txt 3 --algo astar-pdb --pdb pdb_3x3.pdb > temp_astar_pdb.csv
+./puzzle_solver results/pdb_analysis/random_3x3.txt 3 --algo astar-pdb --pdb pdb_3x3.pdb --no-mirror \
+    > temp_astar_pdb_nomirror.csv
+
+mismatches=$(paste -d',' <(cut -d',' -f3 temp_table.csv) <(cut -d',' -f3 temp_astar_pdb.csv) \
+                         <(cut -d',' -f3 temp_astar_pdb_nomirror.csv) |
+             awk -F',' 'NR > 1 && ($1 != $2 || $1 != $3) {count++} END {print count + 0}')
+boards=$(($(wc -l < temp_table.csv) - 1))
+rm -f temp_table.csv temp_astar_pdb.csv temp_astar_pdb_nomirror.csv
+echo "Boards: $boards, A*-pdb mismatches vs table: $mismatches" > results/pdb_analysis/astar_pdb_3x3_check.txt
+
+if [ "$boards" -le 0 ] || [ "$mismatches" -ne 0 ]; then
+    echo "❌ A*-pdb no coincide con la tabla 3x3 en $mismatches de $boards tableros"
+    exit 1
+fi
+echo "✅ A*-pdb óptimo en los $boards tableros 3x3"
+echo ""
+
+echo "========================================================"
+echo "    RESULTADOS DE TAREA 13"
+echo "========================================================"
+echo ""
+echo "✅ Archivos generados:"
+echo "   📄 build_benchmark.txt - Tiempo y tamaño de construcción por patrón"
+echo "   📄 H1_manhattan.csv / H1_pdb.csv - A* con Manhattan y con PDB"
+echo "   📄 IDA_lc.csv / IDA_pdb.csv - IDA* con Manhattan+conflictos y con PDB"
+echo "   📄 node_reduction.csv - Reducción de nodos por puzzle"
+echo "   📄 node_reduction_summary.csv - Reducción total por algoritmo"
+echo "   📄 astar_pdb_3x3_check.txt - A*-pdb contra la tabla 3x3 (debe ser 0 discrepancias)"
+echo ""
+echo "✅ TAREA 13 COMPLETADA EXITOSAMENTE"
+echo "========================================================"
@@ -0,0 +1,224 @@
+/**
+ * @file work_stealing.h
+ * @brief Work-stealing batch scheduler for independent tasks (puzzle indices)
+ *
+ * Tasks are given in priority order (hardest first) and dealt round-robin to
+ * one deque per thread, so every thread starts on its share of the hardest
+ * work. The owner pops from the bottom of its deque, hardest remaining task
+ * first; an idle thread steals from the top of another thread's deque, which
+ * holds that thread's easiest remaining task. Hard tasks start early and the
+ * short ones left at the end fill the gaps, so the batch does not end with a
+ * single thread grinding through a late hard board.
+ *
+ * WorkStealingDeque is the Chase-Lev deque (with the C11 memory orderings of
+ * Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models",
+ * PPoPP 2013). Capacity is fixed: the batch is known before it starts and no
+ * task spawns new ones, which also means a thread that finds every deque
+ * empty is done for good.
+ *
+ * The scheduler is threading-agnostic: each thread of a parallel region (e.g.
+ * `#pragma omp parallel`) calls run(tid, fn).
+ */
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace puzzle {
+
+class WorkStealingDeque {
+public:
+    enum StealResult { STOLEN, EMPTY, CONTENDED };
+
+private:
+    std::unique_ptr<std::atomic<int>[]> tasks_;
+    long long capacity_;
+    std::atomic<long long> top_;      // next task to steal
+    std::atomic<long long> bottom_;   // one past the owner's newest task
+
+    WorkStealingDeque(const WorkStealingDeque&);
+    WorkStealingDeque& operator=(const WorkStealingDeque&);
+
+public:
+    explicit WorkStealingDeque(size_t capacity)
+        : tasks_(new std::atomic<int>[capacity > 0 ? capacity : 1]),
+          capacity_(capacity > 0 ? static_cast<long long>(capacity) : 1),
+          top_(0), bottom_(0) {}
+
+    /**
+     * @brief Owner only: adds @p task at the bottom; the deque must not be full
+     */
+    void push(int task) {
+        long long b = bottom_.load(std::memory_order_relaxed);
+        tasks_[b % capacity_].store(task, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Owner only: takes the newest task; false if the deque is empty
+     */
+    bool pop(int& task) {
+        long long b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {   // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        task = tasks_[b % capacity_].load(std::memory_order_relaxed);
+        if (t == b) {   // last task: race the thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Any thread: takes the oldest task
+     */
+    StealResult steal(int& task) {
+        long long t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return EMPTY;
+
+        task = tasks_[t % capacity_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return CONTENDED;
+        }
+        return STOLEN;
+    }
+};
+
+/**
+ * @brief Per-thread counters of one batch; times in ms since the batch was built
+ */
+struct WorkerStats {
+    size_t tasks;          // tasks executed (own + stolen)
+    size_t steals;         // successful steals
+    size_t steal_misses;   // steal attempts that found nothing or lost a race
+    double busy_ms;        // time inside the task function
+    double finish_ms;      // when this thread found no work left anywhere
+    double idle_ms;        // searching for work + waiting for the batch to end
+};
+
+class WorkStealingScheduler {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    int threads_;
+    std::vector<std::unique_ptr<WorkStealingDeque> > deques_;
+    std::vector<WorkerStats> stats_;
+    Clock::time_point start_;
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+    }
+
+    // Scans the other deques starting after `tid`; false once all are empty
+    bool stealAny(int tid, int& task) {
+        WorkerStats& s = stats_[tid];
+        while (true) {
+            bool contended = false;
+            for (int k = 1; k < threads_; k++) {
+                int victim = (tid + k) % threads_;
+                WorkStealingDeque::StealResult r = deques_[victim]->steal(task);
+                if (r == WorkStealingDeque::STOLEN) {
+                    s.steals++;
+                    return true;
+                }
+                s.steal_misses++;
+                if (r == WorkStealingDeque::CONTENDED) contended = true;
+            }
+            if (!contended) return false;
+        }
+    }
+
+public:
+    /**
+     * @param order tasks in priority order, most important first
+     */
+    WorkStealingScheduler(int threads, const std::vector<int>& order)
+        : threads_(threads > 0 ? threads : 1), stats_(threads_, WorkerStats()) {
+        size_t per_thread = order.size() / threads_ + 1;
+        for (int t = 0; t < threads_; t++) {
+            deques_.emplace_back(new WorkStealingDeque(per_thread));
+        }
+        // Deal round-robin, then push each share in reverse so the owner pops
+        // its most important task first and thieves take the least important
+        std::vector<std::vector<int> > shares(threads_);
+        for (size_t i = 0; i < order.size(); i++) shares[i % threads_].push_back(order[i]);
+        for (int t = 0; t < threads_; t++) {
+            for (size_t i = shares[t].size(); i-- > 0;) deques_[t]->push(shares[t][i]);
+        }
+        start_ = Clock::now();
+    }
+
+    /**
+     * @brief Runs tasks on the calling thread until the whole batch is drained
+     *
+     * Call once from every thread, with tid in [0, threads). fn(task, tid).
+     * Before the first run(), only thread `tid` may touch deque `tid`; the
+     * constructor's pushes are published by the start of the parallel region.
+     */
+    template <typename Fn>
+    void run(int tid, Fn fn) {
+        WorkerStats& s = stats_[tid];
+        int task;
+        while (deques_[tid]->pop(task) || stealAny(tid, task)) {
+            double begin = elapsedMs();
+            fn(task, tid);
+            s.busy_ms += elapsedMs() - begin;
+            s.tasks++;
+        }
+        s.finish_ms = elapsedMs();
+    }
+
+    /**
+     * @brief Call after every run() returned: fills idle_ms from the batch end
+     */
+    const std::vector<WorkerStats>& stats() {
+        double end = batchEndMs();
+        for (size_t t = 0; t < stats_.size(); t++) {
+            stats_[t].idle_ms = std::max(0.0, end - stats_[t].busy_ms);
+        }
+        return stats_;
+    }
+
+    double batchEndMs() const {
+        double end = 0.0;
+        for (size_t t = 0; t < stats_.size(); t++) end = std::max(end, stats_[t].finish_ms);
+        return end;
+    }
+
+    /**
+     * @brief Time from the first thread running out of work to the batch end
+     */
+    double tailLatencyMs() const {
+        if (stats_.empty()) return 0.0;
+        double first_idle = stats_[0].finish_ms;
+        for (size_t t = 1; t < stats_.size(); t++) first_idle = std::min(first_idle, stats_[t].finish_ms);
+        return batchEndMs() - first_idle;
+    }
+
+    size_t totalSteals() const {
+        size_t total = 0;
+        for (size_t t = 0; t < stats_.size(); t++) total += stats_[t].steals;
+        return total;
+    }
+};
+
+} // namespace puzzle
+
+#endif // WORK_STEALING_H